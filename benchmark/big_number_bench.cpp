@@ -0,0 +1,122 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * big_number operations across operand sizes from 1 to 10^6 limbs,
+ * reports bytes of limbs processed per second and heap allocations per operation,
+ * machine readable results: big_number_bench --benchmark_out=big_number.json --benchmark_out_format=json
+ * (configure with -DCMAKE_BUILD_TYPE=Release, numbers of unoptimized build say little)
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "counting_allocator.h"
+#include "../src/big_number/big_number.h"
+
+static const size_t LIMB_DIGITS = 9;
+static const size_t LIMB_BYTES = 4;
+
+static std::string random_digits(size_t n, int base, unsigned seed) {
+    const char *digits = "0123456789abcdef";
+    std::mt19937 gen(seed);
+    std::string s(n, '0');
+    for (auto &c: s) {
+        c = digits[gen() % base];
+    }
+    s[0] = digits[1 + gen() % (base - 1)];
+    return s;
+}
+
+static big_number random_number(size_t limbs, unsigned seed) {
+    return big_number(random_digits(limbs * LIMB_DIGITS, 10, seed));
+}
+
+/**
+ * runs f in benchmark loop, bytes is size of limbs touched by one call
+ */
+template<typename F>
+static void measure(benchmark::State &state, size_t bytes, F f) {
+    size_t before = counting_allocator::allocations();
+    for (auto _: state) {
+        f();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * bytes));
+    state.counters["allocs_per_op"] = benchmark::Counter((double) (counting_allocator::allocations() - before),
+                                                         benchmark::Counter::kAvgIterations);
+}
+
+static void BM_add(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    big_number a = random_number(n, 1), b = random_number(n, 2);
+    measure(state, 3 * n * LIMB_BYTES, [&] {
+        big_number r = a + b;
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_sub(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    big_number a = random_number(n, 1), b = random_number(n, 2);
+    measure(state, 3 * n * LIMB_BYTES, [&] {
+        big_number r = a - b;
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_mul(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    big_number a = random_number(n, 1), b = random_number(n, 2);
+    measure(state, 4 * n * LIMB_BYTES, [&] {
+        big_number r = a * b;
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+/**
+ * base of n / 4 limbs to the power of 4, result has about n limbs
+ */
+static void BM_pow(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    big_number a = random_number(std::max<size_t>(1, n / 4), 1), e(4);
+    measure(state, n * LIMB_BYTES, [&] {
+        big_number r = a ^ e;
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_from_string(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    int base = (int) state.range(1);
+    // as many digits as fit into n limbs
+    size_t digits = base == 10 ? n * LIMB_DIGITS : n * 30 / 4;
+    std::string s = random_digits(digits, base, 1);
+    measure(state, n * LIMB_BYTES, [&] {
+        big_number r(s, base);
+        benchmark::DoNotOptimize(r);
+    });
+}
+
+static void BM_to_string(benchmark::State &state) {
+    size_t n = (size_t) state.range(0);
+    int base = (int) state.range(1);
+    big_number a = random_number(n, 1);
+    measure(state, n * LIMB_BYTES, [&] {
+        std::string s = to_string(a, base);
+        benchmark::DoNotOptimize(s);
+    });
+}
+
+BENCHMARK(BM_add)->RangeMultiplier(10)->Range(1, 1000000);
+BENCHMARK(BM_sub)->RangeMultiplier(10)->Range(1, 1000000);
+BENCHMARK(BM_mul)->RangeMultiplier(10)->Range(1, 1000000)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_pow)->RangeMultiplier(10)->Range(1, 1000000)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_from_string)->ArgsProduct({benchmark::CreateRange(1, 1000000, 10), {10}})
+        ->ArgsProduct({benchmark::CreateRange(1, 100000, 10), {16}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_to_string)->ArgsProduct({benchmark::CreateRange(1, 1000000, 10), {10}})
+        ->ArgsProduct({benchmark::CreateRange(1, 100000, 10), {16}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
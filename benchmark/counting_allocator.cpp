@@ -0,0 +1,58 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "counting_allocator.h"
+
+// size of every block is kept in front of it, header keeps alignment of malloc
+static const size_t HEADER = 16;
+static std::atomic<size_t> count(0);
+static std::atomic<size_t> live(0);
+static std::atomic<size_t> peak(0);
+
+void *operator new(size_t size) {
+    char *p = (char *) std::malloc(size + HEADER);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    *(size_t *) p = size;
+    count.fetch_add(1, std::memory_order_relaxed);
+    size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t most = peak.load(std::memory_order_relaxed);
+    while (now > most && !peak.compare_exchange_weak(most, now, std::memory_order_relaxed)) {
+    }
+    return p + HEADER;
+}
+
+void operator delete(void *p) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    char *block = (char *) p - HEADER;
+    live.fetch_sub(*(size_t *) block, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+size_t counting_allocator::allocations() {
+    return count.load(std::memory_order_relaxed);
+}
+
+size_t counting_allocator::live_bytes() {
+    return live.load(std::memory_order_relaxed);
+}
+
+size_t counting_allocator::peak_bytes() {
+    return peak.load(std::memory_order_relaxed);
+}
+
+void counting_allocator::reset_peak() {
+    peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
@@ -0,0 +1,40 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_COUNTING_ALLOCATOR_H
+#define ALGORITHMS_COUNTING_ALLOCATOR_H
+
+#include <cstddef>
+
+/**
+ * counters of global operator new and delete, which are replaced in counting_allocator.cpp
+ * for every benchmark linked with it, replacements stay in their own translation unit,
+ * so compiler never inlines them into new expressions and sees malloc and free behind them
+ */
+namespace counting_allocator {
+
+    /**
+     * @return number of allocations since start of program
+     */
+    size_t allocations();
+
+    /**
+     * @return bytes allocated and not freed yet
+     */
+    size_t live_bytes();
+
+    /**
+     * @return the most bytes allocated at once since last reset_peak
+     */
+    size_t peak_bytes();
+
+    /**
+     * starts tracking peak from bytes allocated now
+     */
+    void reset_peak();
+}
+
+
+#endif //ALGORITHMS_COUNTING_ALLOCATOR_H
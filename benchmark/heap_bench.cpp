@@ -0,0 +1,638 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * heaps and std::priority_queue replaying the same traces of operations,
+ * reports time per operation, cache misses per operation (linux perf counters, when kernel allows them)
+ * and bytes held per key at peak, every replay checks order of popped keys against trace
+ *
+ * synthetic traces for sizes 10^3 to 10^6, larger ones up to 10^8 with --max_size=100000000
+ * (such traces and heaps take gigabytes), recorded traces with --trace=file (repeatable),
+ * file holds one operation per line: "push k", "pop", "decrease k new_k" or "remove k"
+ * on distinct integer keys, as logged by application
+ *
+ * machine readable results: heap_bench --benchmark_out=heap.json --benchmark_out_format=json
+ * (configure with -DCMAKE_BUILD_TYPE=Release, numbers of unoptimized build say little)
+ */
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "counting_allocator.h"
+#include "../src/heap/binary_heap.h"
+#include "../src/heap/d_ary_heap.h"
+#include "../src/heap/fibonacci_heap.h"
+#include "../src/heap/handle_heap.h"
+#include "../src/heap/indexed_binary_heap.h"
+#include "../src/heap/pairing_heap.h"
+#include "../src/heap/radix_heap.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * hardware counter of cache misses of this thread, unavailable outside linux
+ * or when perf_event_paranoid forbids it
+ */
+class cache_miss_counter {
+
+public:
+
+    cache_miss_counter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~cache_miss_counter() {
+#ifdef __linux__
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    cache_miss_counter(const cache_miss_counter &) = delete;
+
+    cache_miss_counter &operator=(const cache_miss_counter &) = delete;
+
+    bool available() const {
+        return fd >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+    }
+
+    /**
+     * @return misses counted between all starts and stops so far
+     */
+    uint64_t value() const {
+        uint64_t v = 0;
+#ifdef __linux__
+        if (fd < 0 || read(fd, &v, sizeof(v)) != sizeof(v)) {
+            return 0;
+        }
+#endif
+        return v;
+    }
+
+private:
+    int fd = -1;
+};
+
+enum op_kind : uint8_t {
+    PUSH, POP, DECREASE, REMOVE
+};
+
+/**
+ * one operation of trace, id names key for queues addressed by handles,
+ * ids are never reused, so id of key changed by decrease stays the same
+ */
+struct op {
+    op_kind kind;
+    uint32_t id;
+    long long key;
+    long long new_key;
+};
+
+struct trace {
+    std::vector<op> ops;
+    // ids are 0 .. ids - 1
+    size_t ids = 0;
+    // most keys in queue at once
+    size_t peak = 0;
+    // no key pushed or decreased below last popped one, so radix heap can replay it
+    bool monotone = true;
+    // hash of popped keys in order
+    uint64_t checksum = 0;
+};
+
+static void add_to_checksum(uint64_t &checksum, long long key) {
+    checksum = checksum * 1000003 + (uint64_t) key;
+}
+
+/**
+ * records operations while running them on reference queue,
+ * which tells popped keys and lets generators pick keys still in queue
+ */
+class trace_builder {
+
+public:
+
+    trace t;
+
+    uint32_t push(long long key) {
+        if (key == LLONG_MIN) {
+            throw "key LLONG_MIN is reserved";
+        }
+        uint32_t id = (uint32_t) t.ids++;
+        t.monotone &= key >= last;
+        q.push(id, key);
+        slot.push_back(live.size());
+        live.push_back(id);
+        t.ops.push_back({PUSH, id, key, 0});
+        t.peak = std::max(t.peak, q.size());
+        return id;
+    }
+
+    /**
+     * @return popped key
+     */
+    long long pop() {
+        if (q.empty()) {
+            throw "pop from empty queue";
+        }
+        uint32_t id = q.top();
+        long long key = q.priority(id);
+        q.pop();
+        _forget(id);
+        last = key;
+        add_to_checksum(t.checksum, key);
+        t.ops.push_back({POP, id, 0, 0});
+        return key;
+    }
+
+    void decrease(uint32_t id, long long new_key) {
+        long long key = q.priority(id);
+        if (new_key > key) {
+            throw "cannot increase key";
+        }
+        if (new_key == key) {
+            return;
+        }
+        t.monotone &= new_key >= last;
+        q.decrease(id, new_key);
+        t.ops.push_back({DECREASE, id, key, new_key});
+    }
+
+    void remove(uint32_t id) {
+        t.ops.push_back({REMOVE, id, q.priority(id), 0});
+        q.remove(id);
+        _forget(id);
+    }
+
+    size_t size() const {
+        return q.size();
+    }
+
+    long long key(uint32_t id) const {
+        return q.priority(id);
+    }
+
+    template<typename G>
+    uint32_t random_id(G &gen) const {
+        return live[gen() % live.size()];
+    }
+
+    void drain() {
+        while (!q.empty()) {
+            pop();
+        }
+    }
+
+private:
+    indexed_binary_heap<long long> q;
+    // ids in queue and position of every id in live
+    std::vector<uint32_t> live;
+    std::vector<size_t> slot;
+    long long last = LLONG_MIN;
+
+    void _forget(uint32_t id) {
+        uint32_t moved = live.back();
+        live[slot[id]] = moved;
+        slot[moved] = slot[id];
+        live.pop_back();
+    }
+};
+
+// keys of generated traces are value * 2^32 + id, so they are distinct and still ordered by value
+static long long make_key(long long value, uint32_t id) {
+    return (value << 32) | id;
+}
+
+/**
+ * n random keys, then 2n pushes, pops, decreases and removes mixed 4:3:2:1, then all pops
+ */
+static trace mixed_trace(size_t n) {
+    std::mt19937_64 gen(1);
+    trace_builder b;
+    size_t ids = 0;
+    for (size_t i = 0; i < n; i++) {
+        b.push(make_key(gen() % (1u << 30), ids++));
+    }
+    for (size_t i = 0; i < 2 * n; i++) {
+        unsigned r = gen() % 10;
+        if (r < 4 || b.size() == 0) {
+            b.push(make_key(gen() % (1u << 30), ids++));
+        } else if (r < 7) {
+            b.pop();
+        } else if (r < 9) {
+            uint32_t id = b.random_id(gen);
+            long long value = b.key(id) >> 32;
+            b.decrease(id, make_key(value - value * (gen() % 64) / 64, id));
+        } else {
+            b.remove(b.random_id(gen));
+        }
+    }
+    b.drain();
+    return b.t;
+}
+
+/**
+ * dijkstra from node 0 of random graph with n nodes, 8 edges out of every node
+ * and weights from 1 to 1000, every shorter path found decreases key of its node
+ */
+static trace dijkstra_trace(size_t n) {
+    const size_t DEGREE = 8;
+    const uint32_t NONE = (uint32_t) -1;
+    std::mt19937_64 gen(2);
+    trace_builder b;
+    std::vector<uint32_t> id_of(n, NONE), node_of;
+    std::vector<bool> done(n, false);
+    id_of[0] = b.push(make_key(0, 0));
+    node_of.push_back(0);
+    while (b.size() > 0) {
+        long long key = b.pop();
+        long long dist = key >> 32;
+        size_t v = node_of[(uint32_t) key];
+        done[v] = true;
+        // edges are drawn when node is settled, graph is never stored
+        for (size_t i = 0; i < DEGREE; i++) {
+            size_t u = gen() % n;
+            long long d = dist + 1 + (long long) (gen() % 1000);
+            if (done[u]) continue;
+            if (id_of[u] == NONE) {
+                id_of[u] = b.push(make_key(d, (uint32_t) node_of.size()));
+                node_of.push_back(u);
+            } else if (d < (b.key(id_of[u]) >> 32)) {
+                b.decrease(id_of[u], make_key(d, id_of[u]));
+            }
+        }
+    }
+    return b.t;
+}
+
+/**
+ * n increasing keys, then all pops
+ */
+static trace sorted_trace(size_t n) {
+    trace_builder b;
+    for (size_t i = 0; i < n; i++) {
+        b.push(make_key((long long) i, (uint32_t) i));
+    }
+    b.drain();
+    return b.t;
+}
+
+/**
+ * n decreasing keys, every push goes up to the top of binary heaps, then all pops
+ */
+static trace reversed_trace(size_t n) {
+    trace_builder b;
+    for (size_t i = 0; i < n; i++) {
+        b.push(make_key((long long) (n - i), (uint32_t) i));
+    }
+    b.drain();
+    return b.t;
+}
+
+/**
+ * n random keys, then n times random key is decreased below all others and popped,
+ * so every decrease goes the whole way up and cuts deep nodes
+ */
+static trace decrease_to_top_trace(size_t n) {
+    std::mt19937_64 gen(3);
+    trace_builder b;
+    for (size_t i = 0; i < n; i++) {
+        b.push(make_key(2 * (long long) n + (long long) (gen() % (1u << 30)), (uint32_t) i));
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint32_t id = b.random_id(gen);
+        b.decrease(id, make_key((long long) i, id));
+        b.pop();
+    }
+    return b.t;
+}
+
+/**
+ * reads trace recorded by application, keys of the file are replayed as they are
+ */
+static trace load_trace(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw "cannot open trace file";
+    }
+    trace_builder b;
+    // id of every key in queue
+    std::unordered_map<long long, uint32_t> ids;
+    std::string word;
+    long long key, new_key;
+    while (in >> word) {
+        if (word == "push") {
+            if (!(in >> key) || ids.count(key)) {
+                throw "push needs key not in queue";
+            }
+            ids[key] = b.push(key);
+        } else if (word == "pop") {
+            ids.erase(b.pop());
+        } else if (word == "decrease") {
+            if (!(in >> key >> new_key) || !ids.count(key) || (new_key != key && ids.count(new_key))) {
+                throw "decrease needs key in queue and new key not in queue";
+            }
+            uint32_t id = ids[key];
+            b.decrease(id, new_key);
+            ids.erase(key);
+            ids[new_key] = id;
+        } else if (word == "remove") {
+            if (!(in >> key) || !ids.count(key)) {
+                throw "remove needs key in queue";
+            }
+            b.remove(ids[key]);
+            ids.erase(key);
+        } else {
+            throw "unknown operation in trace file";
+        }
+    }
+    return b.t;
+}
+
+/**
+ * trace of given source and size, only the last one is kept,
+ * benchmarks are registered so that all heaps replay a trace one after another
+ */
+static const trace &get_trace(const std::string &name, const std::function<trace()> &make) {
+    static std::string current;
+    static trace t;
+    if (name != current) {
+        t = trace();
+        current.clear();
+        t = make();
+        current = name;
+    }
+    return t;
+}
+
+/**
+ * heaps addressed by keys
+ */
+template<typename Q>
+struct keyed_driver {
+    Q q;
+
+    explicit keyed_driver(size_t) {}
+
+    void push(const op &o) { q.push(o.key); }
+
+    long long pop() {
+        long long key = q.top();
+        q.pop();
+        return key;
+    }
+
+    void decrease(const op &o) { q.decrease(o.key, o.new_key); }
+
+    void remove(const op &o) { q.remove(o.key); }
+};
+
+/**
+ * std::priority_queue used the usual way for lack of decrease and remove:
+ * decrease pushes key once again and stale copies are skipped on pop,
+ * current key of every id tells which copies are stale
+ */
+struct std_driver {
+    typedef std::pair<long long, uint32_t> E;
+    std::priority_queue<E, std::vector<E>, std::greater<E>> q;
+    std::vector<long long> current;
+
+    explicit std_driver(size_t ids) : current(ids) {}
+
+    void push(const op &o) {
+        current[o.id] = o.key;
+        q.push({o.key, o.id});
+    }
+
+    long long pop() {
+        while (current[q.top().second] != q.top().first) {
+            q.pop();
+        }
+        long long key = q.top().first;
+        q.pop();
+        return key;
+    }
+
+    void decrease(const op &o) {
+        current[o.id] = o.new_key;
+        q.push({o.new_key, o.id});
+    }
+
+    void remove(const op &o) {
+        current[o.id] = LLONG_MIN;
+    }
+};
+
+struct indexed_driver {
+    indexed_binary_heap<long long> q;
+
+    explicit indexed_driver(size_t ids) : q(ids) {}
+
+    void push(const op &o) { q.push(o.id, o.key); }
+
+    long long pop() {
+        long long key = q.priority(q.top());
+        q.pop();
+        return key;
+    }
+
+    void decrease(const op &o) { q.decrease(o.id, o.new_key); }
+
+    void remove(const op &o) { q.remove(o.id); }
+};
+
+struct handle_driver {
+    typedef handle_heap<long long, uint32_t> Q;
+    Q q;
+    std::vector<Q::HANDLE> handles;
+
+    explicit handle_driver(size_t ids) : handles(ids) {}
+
+    void push(const op &o) { handles[o.id] = q.push(o.key, o.id); }
+
+    long long pop() {
+        long long key = q.priority(q.top());
+        q.pop();
+        return key;
+    }
+
+    void decrease(const op &o) { q.decrease(handles[o.id], o.new_key); }
+
+    void remove(const op &o) { q.remove(handles[o.id]); }
+};
+
+/**
+ * @return checksum of popped keys
+ */
+template<typename D>
+static uint64_t replay(D &d, const trace &t) {
+    uint64_t checksum = 0;
+    for (const op &o: t.ops) {
+        switch (o.kind) {
+            case PUSH:
+                d.push(o);
+                break;
+            case POP:
+                add_to_checksum(checksum, d.pop());
+                break;
+            case DECREASE:
+                d.decrease(o);
+                break;
+            case REMOVE:
+                d.remove(o);
+                break;
+        }
+    }
+    return checksum;
+}
+
+/**
+ * replays trace on fresh queue in every iteration, queue is built and destroyed outside of counters
+ */
+template<typename D>
+static void BM_replay(benchmark::State &state, std::string name, std::function<trace()> make) {
+    const trace *t;
+    try {
+        t = &get_trace(name, make);
+    } catch (const char *e) {
+        state.SkipWithError(e);
+        return;
+    }
+    if (std::is_same<D, keyed_driver<radix_heap<long long>>>::value && !t->monotone) {
+        state.SkipWithError("keys go below popped min, radix heap cannot replay trace");
+        return;
+    }
+    cache_miss_counter misses;
+    double ns = 0;
+    size_t footprint = 0;
+    for (auto _: state) {
+        size_t before = counting_allocator::live_bytes();
+        counting_allocator::reset_peak();
+        D d(t->ids);
+        auto start = std::chrono::steady_clock::now();
+        misses.start();
+        uint64_t checksum = replay(d, *t);
+        misses.stop();
+        ns += (double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        footprint = std::max(footprint, counting_allocator::peak_bytes() - before);
+        if (checksum != t->checksum) {
+            state.SkipWithError("keys popped in wrong order");
+            break;
+        }
+    }
+    if (state.error_occurred()) {
+        return;
+    }
+    double ops = (double) t->ops.size() * (double) state.iterations();
+    state.SetItemsProcessed((int64_t) ops);
+    state.counters["ns_per_op"] = ns / ops;
+    if (misses.available()) {
+        state.counters["misses_per_op"] = (double) misses.value() / ops;
+    }
+    state.counters["bytes_per_key"] = (double) footprint / (double) std::max<size_t>(1, t->peak);
+    state.counters["ops"] = (double) t->ops.size();
+}
+
+/**
+ * registers replay of trace by every queue, radix heap only when trace may be monotone
+ */
+static void register_trace(const std::string &name, const std::function<trace()> &make, bool monotone) {
+    auto add = [&](const char *queue, void (*f)(benchmark::State &, std::string, std::function<trace()>)) {
+        benchmark::RegisterBenchmark((name + "/" + queue).c_str(), f, name, make)
+                ->Unit(benchmark::kMillisecond)->UseRealTime();
+    };
+    add("std_priority_queue", BM_replay<std_driver>);
+    add("binary_heap", BM_replay<keyed_driver<binary_heap<long long>>>);
+    add("d_ary_heap", BM_replay<keyed_driver<d_ary_heap<long long>>>);
+    add("fibonacci_heap", BM_replay<keyed_driver<fibonacci_heap<long long>>>);
+    add("pairing_heap", BM_replay<keyed_driver<pairing_heap<long long>>>);
+    if (monotone) {
+        add("radix_heap", BM_replay<keyed_driver<radix_heap<long long>>>);
+    }
+    add("indexed_binary_heap", BM_replay<indexed_driver>);
+    add("handle_heap", BM_replay<handle_driver>);
+}
+
+int main(int argc, char **argv) {
+    size_t max_size = 1000000;
+    std::vector<std::string> files;
+    // own flags are taken out before google benchmark reads the rest
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 11, "--max_size=") == 0) {
+            max_size = (size_t) std::stod(arg.substr(11));
+        } else if (arg.compare(0, 8, "--trace=") == 0) {
+            files.push_back(arg.substr(8));
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    for (size_t n = 1000; n <= max_size; n *= 10) {
+        std::string size = "/" + std::to_string(n);
+        register_trace("mixed" + size, [n] { return mixed_trace(n); }, false);
+        register_trace("dijkstra" + size, [n] { return dijkstra_trace(n); }, true);
+        register_trace("sorted" + size, [n] { return sorted_trace(n); }, true);
+        register_trace("reversed" + size, [n] { return reversed_trace(n); }, true);
+        register_trace("decrease_to_top" + size, [n] { return decrease_to_top_trace(n); }, true);
+    }
+    for (auto &file: files) {
+        register_trace("recorded:" + file, [file] { return load_trace(file); }, true);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
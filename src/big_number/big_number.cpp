@@ -4,70 +4,126 @@
 //
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <utility>
 #include "big_number.h"
+#include "limb_kernels.h"
+#include "ntt.h"
+#include "task_pool.h"
+
+static_assert(limb_kernels::BASE == 1000000000, "limb kernels have to work in base of big_number");
+
+size_t big_number::KARATSUBA_THRESHOLD = 200;
+size_t big_number::TOOM3_THRESHOLD = 600;
+size_t big_number::NTT_THRESHOLD = 30000;
+size_t big_number::BURNIKEL_ZIEGLER_THRESHOLD = 60;
+size_t big_number::PARALLEL_THRESHOLD = 2000;
+unsigned big_number::MAX_WORKERS = std::max(1u, std::thread::hardware_concurrency());
+
+/**
+ * threads (calling one included) which multiplication running on this thread may occupy,
+ * 0 outside of parallel multiplication
+ */
+static thread_local unsigned workers_left = 0;
+
+/**
+ * sets workers_left of calling thread for its lifetime
+ */
+class workers_scope {
+public:
+    explicit workers_scope(unsigned workers) : previous(workers_left) {
+        workers_left = workers;
+    }
+
+    ~workers_scope() {
+        workers_left = previous;
+    }
+
+private:
+    unsigned previous;
+};
+
+/**
+ * pool of all parallel multiplications, started by the first one with MAX_WORKERS threads
+ */
+static task_pool &shared_pool() {
+    static task_pool pool(big_number::MAX_WORKERS);
+    return pool;
+}
+
+big_number::big_number() : number(1, 0), sign(PLUS) {
 
-big_number::big_number() {
-    number.push_back(0);
-    sign = PLUS;
 }
 
-big_number::big_number(int a) {
-    number.push_back(a < 0 ? -a : a);
-    sign = a < 0 ? MINUS : PLUS;
+big_number::big_number(int a) : sign(a < 0 ? MINUS : PLUS) {
+    long long x = a < 0 ? -(long long) a : a;
+    do {
+        number.push_back((LIMB) (x % BASE));
+        x /= BASE;
+    } while (x > 0);
 }
 
 big_number::big_number(const STR& s, int base) {
-    SDI n = from_string(s, base);
-    number = n.first;
+    SVL n = from_string(s, base);
+    number = std::move(n.first);
     sign = n.second;
+    normalize(*this);
 }
 
 big_number &big_number::operator+=(const big_number &a) {
-    big_number x = *this + a;
-    this->number = x.number;
-    this->sign = x.sign;
+    add_operation(*this, a);
     return *this;
 }
 
 big_number &big_number::operator-=(const big_number &a) {
-    big_number x = *this - a;
-    this->number = x.number;
-    this->sign = x.sign;
+    sub_operation(*this, a);
     return *this;
 }
 
 big_number &big_number::operator*=(const big_number &a) {
-    big_number x = *this * a;
-    this->number = x.number;
-    this->sign = x.sign;
+    mul_operation(*this, a);
     return *this;
 }
 
 big_number &big_number::operator^=(const big_number &a) {
-    big_number x = *this ^ a;
-    this->number = x.number;
-    this->sign = x.sign;
+    pow_operation(*this, a);
     return *this;
 }
 
 big_number &big_number::operator/=(const big_number &a) {
-    big_number x = *this / a;
-    this->number = x.number;
-    this->sign = x.sign;
+    div_operation(*this, a);
     return *this;
 }
 
 big_number &big_number::operator%=(const big_number &a) {
-    big_number x = *this % a;
-    this->number = x.number;
-    this->sign = x.sign;
+    mod_operation(*this, a);
     return *this;
 }
 
-big_number::big_number(DI a, SIGN s) {
+big_number &big_number::operator<<=(size_t k) {
+    number = shift_left(number, k);
+    return *this;
+}
+
+big_number &big_number::operator>>=(size_t k) {
+    VL q, r;
+    divmod(number, shift_left(VL(1, 1), k), q, r);
+    // rounding towards minus infinity
+    if (sign == MINUS && !is_zero(r)) {
+        add(q, VL(1, 1));
+    }
+    number.swap(q);
+    normalize(*this);
+    return *this;
+}
+
+big_number::big_number(VL a, SIGN s) {
     number = std::move(a);
     sign = s;
+    normalize(*this);
 }
 
 big_number::SIGN big_number::change_sign(const big_number::SIGN &sign) {
@@ -75,7 +131,7 @@ big_number::SIGN big_number::change_sign(const big_number::SIGN &sign) {
 }
 
 std::string to_string(const big_number &a, int base) {
-    return big_number::to_string(big_number::SDI(a.number, a.sign), base);
+    return big_number::to_string(a.number, a.sign, base);
 }
 
 bool compare(const big_number &a, const big_number &b) {
@@ -86,36 +142,82 @@ big_number abs(const big_number& a) {
     return big_number(a.number);
 }
 
-big_number operator+(const big_number &a) {
-    return big_number(a.number, a.sign);
+std::pair<big_number, big_number> divmod(const big_number &a, const big_number &b) {
+    if (big_number::is_zero(b.number)) {
+        throw "division by zero";
+    }
+    big_number q, r;
+    big_number::divmod(a.number, b.number, q.number, r.number);
+    q.sign = a.sign == b.sign ? big_number::PLUS : big_number::MINUS;
+    r.sign = a.sign;
+    big_number::normalize(q);
+    big_number::normalize(r);
+    return {q, r};
 }
 
-big_number operator-(const big_number &a) {
-    return big_number(a.number, big_number::change_sign(a.sign));
+big_number pow_mod(const big_number &base, const big_number &exp, const big_number &m) {
+    return big_number::montgomery_context(m).pow(base, exp);
 }
 
-big_number operator+(const big_number &a, const big_number &b) {
-    return big_number::add_operation(a, b);
+big_number multiply(const big_number &a, const big_number &b, unsigned workers) {
+    workers_scope scope(std::max(workers, 1u));
+    return a * b;
 }
 
-big_number operator-(const big_number &a, const big_number &b) {
-    return big_number::sub_operation(a, b);
+big_number operator+(const big_number &a) {
+    return a;
 }
 
-big_number operator*(const big_number &a, const big_number &b) {
-    return big_number::mul_operation(a, b);
+big_number operator-(const big_number &a) {
+    return big_number(a.number, big_number::change_sign(a.sign));
 }
 
 big_number operator^(const big_number &a, const big_number &b) {
-    return big_number::pow_operation(a, b);
+    big_number x(a);
+    return x ^= b;
 }
 
 big_number operator/(const big_number &a, const big_number &b) {
-    return big_number::div_operation(a, b);
+    big_number x(a);
+    return x /= b;
 }
 
 big_number operator%(const big_number &a, const big_number &b) {
-    return big_number::mod_operation(a, b);
+    big_number x(a);
+    return x %= b;
+}
+
+big_number operator<<(const big_number &a, size_t k) {
+    big_number x(a);
+    return x <<= k;
+}
+
+big_number operator>>(const big_number &a, size_t k) {
+    big_number x(a);
+    return x >>= k;
+}
+
+big_number gcd(const big_number &a, const big_number &b) {
+    return big_number(big_number::gcd(a.number, b.number));
+}
+
+big_number isqrt(const big_number &a) {
+    if (a.sign == big_number::MINUS) {
+        throw "square root of negative number";
+    }
+    return big_number(big_number::isqrt(a.number));
+}
+
+big_number bitwise_and(const big_number &a, const big_number &b) {
+    return big_number::bitwise(a, b, '&');
+}
+
+big_number bitwise_or(const big_number &a, const big_number &b) {
+    return big_number::bitwise(a, b, '|');
+}
+
+big_number bitwise_xor(const big_number &a, const big_number &b) {
+    return big_number::bitwise(a, b, '^');
 }
 
 bool operator==(const big_number &a, const big_number &b) {
@@ -154,261 +256,1308 @@ std::ostream &operator<<(std::ostream &out, big_number &a) {
     return out;
 }
 
-big_number::SDI big_number::from_string(const big_number::STR &s, int base) {
-    //FIXME
-    DI n, b, t;
-    n.push_back(0); b.push_back(1);
-    bool sign = s[0] == '-' || s[0] == '+';
-    bool minus = s[0] == '-';
-    for (auto c = s.begin() + sign; c != s.end(); c++) {
-        n = mul(n, base);
-        t.push_back(*c > '9' ? *c - 'A' + 10 : *c - '0');
-        n = add(n, t);
-        t.clear();
+size_t big_number::binary_size() const {
+    return BINARY_HEADER + number.size() * sizeof(LIMB);
+}
+
+void big_number::write(std::ostream &out) const {
+    uint64_t n = number.size();
+    uint32_t s = sign == MINUS;
+    out.write((const char *) &n, sizeof(n));
+    out.write((const char *) &s, sizeof(s));
+    out.write((const char *) number.data(), (std::streamsize) (n * sizeof(LIMB)));
+}
+
+big_number big_number::read(std::istream &in) {
+    uint64_t n = 0;
+    uint32_t s = 0;
+    in.read((char *) &n, sizeof(n));
+    in.read((char *) &s, sizeof(s));
+    if (!in || n == 0) {
+        throw "corrupted big_number data";
+    }
+    // limbs are read in chunks, so corrupted length fails on end of stream instead of huge allocation
+    const size_t chunk = 1 << 16;
+    VL a;
+    for (size_t done = 0; done < n;) {
+        size_t k = (size_t) std::min<uint64_t>(chunk, n - done);
+        a.resize(done + k);
+        if (!in.read((char *) (a.data() + done), (std::streamsize) (k * sizeof(LIMB)))) {
+            throw "corrupted big_number data";
+        }
+        done += k;
+    }
+    check_binary(a.data(), a.size(), s);
+    return big_number(std::move(a), s ? MINUS : PLUS);
+}
+
+void big_number::check_binary(const big_number::LIMB *a, size_t n, uint32_t s) {
+    bool valid = n > 0 && s <= 1 && (n == 1 || a[n - 1] != 0) && !(n == 1 && a[0] == 0 && s == 1);
+    for (size_t i = 0; valid && i < n; i++) {
+        valid = a[i] < BASE;
+    }
+    if (!valid) {
+        throw "corrupted big_number data";
+    }
+}
+
+big_number::view::view(const void *data, size_t size) {
+    const char *p = (const char *) data;
+    uint64_t k = 0;
+    uint32_t s = 0;
+    if (size < BINARY_HEADER) {
+        throw "corrupted big_number data";
+    }
+    std::memcpy(&k, p, sizeof(k));
+    std::memcpy(&s, p + sizeof(k), sizeof(s));
+    if (k > (size - BINARY_HEADER) / sizeof(LIMB)) {
+        throw "corrupted big_number data";
     }
-    while (n.front() == 0 && n.size() > 1) {
-        n.pop_front();
+    a = (const LIMB *) (p + BINARY_HEADER);
+    n = (size_t) k;
+    sign = s ? MINUS : PLUS;
+    check_binary(a, n, s);
+}
+
+size_t big_number::view::size() const {
+    return n;
+}
+
+const uint32_t *big_number::view::limbs() const {
+    return a;
+}
+
+bool big_number::view::negative() const {
+    return sign == MINUS;
+}
+
+size_t big_number::view::binary_size() const {
+    return BINARY_HEADER + n * sizeof(LIMB);
+}
+
+big_number big_number::view::value() const {
+    return big_number(VL(a, a + n), sign);
+}
+
+void add_batch(const big_number *a, const big_number *b, big_number *r, size_t n) {
+    big_number::batch(a, b, r, n, [](const big_number *a, const big_number *b, big_number *r, const size_t *lanes,
+                                     size_t k) { big_number::sum_tile(a, b, r, lanes, k, false); },
+                      [](const big_number &x, const big_number &y) -> big_number { return x + y; });
+}
+
+void sub_batch(const big_number *a, const big_number *b, big_number *r, size_t n) {
+    big_number::batch(a, b, r, n, [](const big_number *a, const big_number *b, big_number *r, const size_t *lanes,
+                                     size_t k) { big_number::sum_tile(a, b, r, lanes, k, true); },
+                      [](const big_number &x, const big_number &y) -> big_number { return x - y; });
+}
+
+void mul_batch(const big_number *a, const big_number *b, big_number *r, size_t n) {
+    big_number::batch(a, b, r, n, big_number::mul_tile,
+                      [](const big_number &x, const big_number &y) -> big_number { return x * y; });
+}
+
+template<typename TILE, typename OP>
+void big_number::batch(const big_number *a, const big_number *b, big_number *r, size_t n, TILE tile, OP op) {
+    size_t lanes[BATCH_LANES];
+    for (size_t i0 = 0; i0 < n; i0 += BATCH_LANES) {
+        size_t k = 0;
+        for (size_t i = i0; i < std::min(n, i0 + BATCH_LANES); i++) {
+            if (a[i].number.size() > BATCH_LIMBS || b[i].number.size() > BATCH_LIMBS) {
+                r[i] = op(a[i], b[i]);
+            } else {
+                lanes[k++] = i;
+            }
+        }
+        tile(a, b, r, lanes, k);
+    }
+}
+
+void big_number::sum_tile(const big_number *a, const big_number *b, big_number *r, const size_t *lanes, size_t k,
+                          bool negate) {
+    // limb j of lane l is x[j][l], sums of two limbs with signs and carries fit into int32_t
+    const size_t rows = BATCH_LIMBS + 1;
+    const int32_t base = (int32_t) BASE;
+    int32_t x[rows][BATCH_LANES] = {};
+    for (size_t l = 0; l < k; l++) {
+        const big_number &u = a[lanes[l]], &v = b[lanes[l]];
+        int32_t su = u.sign == MINUS ? -1 : 1, sv = (v.sign == MINUS) != negate ? -1 : 1;
+        for (size_t j = 0; j < u.number.size(); j++) {
+            x[j][l] += su * (int32_t) u.number[j];
+        }
+        for (size_t j = 0; j < v.number.size(); j++) {
+            x[j][l] += sv * (int32_t) v.number[j];
+        }
+    }
+    // limbs in (-2 * BASE, 2 * BASE) are brought to [0, BASE) with carries in [-2, 1],
+    // negative carry out of the last row means that the lane holds BASE^rows - |result|
+    int32_t carry[BATCH_LANES] = {};
+    for (size_t j = 0; j < rows; j++) {
+        for (size_t l = 0; l < BATCH_LANES; l++) {
+            int32_t v = x[j][l] + carry[l];
+            int32_t c = (v >= base) - (v < 0) - (v < -base);
+            x[j][l] = v - c * base;
+            carry[l] = c;
+        }
+    }
+    int32_t borrow[BATCH_LANES] = {};
+    for (size_t j = 0; j < rows; j++) {
+        for (size_t l = 0; l < BATCH_LANES; l++) {
+            int32_t v = (carry[l] < 0 ? -x[j][l] : x[j][l]) + borrow[l];
+            borrow[l] = -(v < 0);
+            x[j][l] = v < 0 ? v + base : v;
+        }
+    }
+    for (size_t l = 0; l < k; l++) {
+        size_t size = rows;
+        while (size > 1 && x[size - 1][l] == 0) {
+            size--;
+        }
+        big_number &t = r[lanes[l]];
+        t.number.resize(size);
+        for (size_t j = 0; j < size; j++) {
+            t.number[j] = (LIMB) x[j][l];
+        }
+        t.sign = carry[l] < 0 ? MINUS : PLUS;
     }
+}
+
+void big_number::mul_tile(const big_number *a, const big_number *b, big_number *r, const size_t *lanes, size_t k) {
+    // columns of products, each one is a sum of at most BATCH_LIMBS products of limbs
+    const size_t rows = 2 * BATCH_LIMBS;
+    LIMB u[BATCH_LIMBS][BATCH_LANES] = {}, v[BATCH_LIMBS][BATCH_LANES] = {};
+    DLIMB x[rows][BATCH_LANES] = {};
+    for (size_t l = 0; l < k; l++) {
+        const big_number &p = a[lanes[l]], &q = b[lanes[l]];
+        for (size_t j = 0; j < p.number.size(); j++) {
+            u[j][l] = p.number[j];
+        }
+        for (size_t j = 0; j < q.number.size(); j++) {
+            v[j][l] = q.number[j];
+        }
+    }
+    for (size_t i = 0; i < BATCH_LIMBS; i++) {
+        for (size_t j = 0; j < BATCH_LIMBS; j++) {
+            for (size_t l = 0; l < BATCH_LANES; l++) {
+                x[i + j][l] += (DLIMB) u[i][l] * v[j][l];
+            }
+        }
+    }
+    DLIMB carry[BATCH_LANES] = {};
+    for (size_t j = 0; j < rows; j++) {
+        for (size_t l = 0; l < BATCH_LANES; l++) {
+            DLIMB t = x[j][l] + carry[l];
+            carry[l] = t / BASE;
+            x[j][l] = t % BASE;
+        }
+    }
+    for (size_t l = 0; l < k; l++) {
+        const big_number &p = a[lanes[l]], &q = b[lanes[l]];
+        SIGN s = p.sign == q.sign ? PLUS : MINUS;
+        size_t size = rows;
+        while (size > 1 && x[size - 1][l] == 0) {
+            size--;
+        }
+        big_number &t = r[lanes[l]];
+        t.number.resize(size);
+        for (size_t j = 0; j < size; j++) {
+            t.number[j] = (LIMB) x[j][l];
+        }
+        t.sign = s;
+        normalize(t);
+    }
+}
+
+big_number::SVL big_number::from_string(const big_number::STR &s, int base) {
+    if (base < 2 || base > 36) {
+        throw "unsupported base";
+    }
+    bool sign = !s.empty() && (s[0] == '-' || s[0] == '+');
+    bool minus = sign && s[0] == '-';
+    VL n = base == 10 ? from_decimal(s, sign) : from_radix(s, sign, base);
+    trim(n);
     return {n, minus ? MINUS : PLUS};
 }
 
-big_number::STR big_number::to_string(const big_number::SDI &a, int base) {
-    //FIXME
-    if (a.first.back() == 0) {
-        return "0";
+big_number::STR big_number::to_string(const big_number::VL &a, big_number::SIGN s, int base) {
+    if (base < 2 || base > 36) {
+        throw "unsupported base";
     }
-    DI ca(a.first);
     STR result;
-    while (ca.back() > 0) {
-        int x = ca.back() % base;
-        result.push_back((char) (x < 10 ? x + '0' : x + 'A' - 10));
-        ca = div(ca, base);
-    }
-    if (a.second == MINUS) {
+    if (s == MINUS) {
         result.push_back('-');
     }
-    std::reverse(result.begin(), result.end());
+    if (base == 10) {
+        to_decimal(a, result);
+        return result;
+    }
+    LIMB chunk;
+    size_t c = radix_chunk(base, chunk);
+    std::vector<VL> pows(1, VL(1, chunk));
+    while (compare(pows.back(), a) <= 0) {
+        pows.push_back(mul(pows.back(), pows.back()));
+    }
+    to_radix(a, pows, pows.size() - 1, false, base, c, result);
     return result;
 }
 
-int big_number::compare(const big_number &a, const big_number &b) {
-    int aSign = a.sign == MINUS ? -1 : 1;
-    int bSign = b.sign == MINUS ? -1 : 1;
-    int len = a.number.size() == b.number.size() ? 0 : a.number.size() < b.number.size() ? -1 : 1;
-    if (aSign < bSign) {
-        return -1;
-    } else if (aSign > bSign) {
-        return 1;
-    } else if ((aSign < 0 && len == 1) || (aSign > 0 && len == -1)) {
-        return -1;
-    } else if ((aSign > 0 && len == 1) || (aSign < 0 && len == -1)) {
-        return 1;
-    } else {
-        for (auto i = a.number.begin(), j = b.number.begin(); i != a.number.end(); i++, j++) {
-            if (*i < *j) {
-                return -1;
-            } else if (*i > *j) {
-                return 1;
+big_number::VL big_number::from_decimal(const big_number::STR &s, size_t begin) {
+    VL n;
+    for (size_t end = s.size(); end > begin;) {
+        size_t from = end - begin > 9 ? end - 9 : begin;
+        LIMB x = 0;
+        for (size_t i = from; i < end; i++) {
+            x = x * 10 + digit_value(s[i]);
+        }
+        n.push_back(x);
+        end = from;
+    }
+    return n;
+}
+
+void big_number::to_decimal(const big_number::VL &a, big_number::STR &out) {
+    out += std::to_string(a.back());
+    char digits[9];
+    for (size_t i = a.size() - 1; i-- > 0;) {
+        LIMB x = a[i];
+        for (int k = 8; k >= 0; k--) {
+            digits[k] = (char) ('0' + x % 10);
+            x /= 10;
+        }
+        out.append(digits, 9);
+    }
+}
+
+big_number::VL big_number::from_radix(const big_number::STR &s, size_t begin, int base) {
+    LIMB chunk;
+    size_t c = radix_chunk(base, chunk);
+    std::vector<VL> blocks;
+    for (size_t end = s.size(); end > begin;) {
+        size_t from = end - begin > c ? end - c : begin;
+        LIMB x = 0;
+        for (size_t i = from; i < end; i++) {
+            x = x * base + digit_value(s[i]);
+        }
+        blocks.emplace_back(1, x);
+        end = from;
+    }
+    if (blocks.empty()) {
+        return VL(1, 0);
+    }
+    // join neighbouring blocks level by level, block on level k holds c * 2^k digits
+    VL p(1, chunk);
+    while (blocks.size() > 1) {
+        std::vector<VL> joined;
+        for (size_t j = 0; j + 1 < blocks.size(); j += 2) {
+            VL x = mul(blocks[j + 1], p);
+            add(x, blocks[j]);
+            joined.push_back(std::move(x));
+        }
+        if (blocks.size() % 2 == 1) {
+            joined.push_back(std::move(blocks.back()));
+        }
+        blocks.swap(joined);
+        if (blocks.size() > 1) {
+            p = mul(p, p);
+        }
+    }
+    return blocks[0];
+}
+
+void big_number::to_radix(const big_number::VL &a, const std::vector<VL> &pows, size_t k, bool pad, int base,
+                          size_t c, big_number::STR &out) {
+    if (k == 0 || a.size() <= RADIX_LEAF_SIZE) {
+        VL x(a);
+        STR digits;
+        do {
+            LIMB chunk = div(x, pows[0][0]);
+            for (size_t i = 0; i < c && (chunk > 0 || !is_zero(x)); i++) {
+                digits.push_back(digit_char(chunk % base));
+                chunk /= base;
             }
+        } while (!is_zero(x));
+        if (digits.empty()) {
+            digits.push_back('0');
+        }
+        if (pad) {
+            digits.resize(c << k, '0');
+        }
+        out.append(digits.rbegin(), digits.rend());
+        return;
+    }
+    VL hi, lo;
+    divmod(a, pows[k - 1], hi, lo);
+    if (!pad && is_zero(hi)) {
+        to_radix(lo, pows, k - 1, false, base, c, out);
+    } else {
+        to_radix(hi, pows, k - 1, pad, base, c, out);
+        to_radix(lo, pows, k - 1, true, base, c, out);
+    }
+}
+
+size_t big_number::radix_chunk(int base, big_number::LIMB &chunk) {
+    size_t c = 0;
+    chunk = 1;
+    while ((DLIMB) chunk * base < BASE) {
+        chunk *= base;
+        c++;
+    }
+    return c;
+}
+
+big_number::LIMB big_number::digit_value(char c) {
+    if (c >= 'a') {
+        return c - 'a' + 10;
+    }
+    return c > '9' ? c - 'A' + 10 : c - '0';
+}
+
+char big_number::digit_char(big_number::LIMB x) {
+    return (char) (x < 10 ? x + '0' : x + 'A' - 10);
+}
+
+int big_number::compare(const big_number &a, const big_number &b) {
+    if (a.sign != b.sign) {
+        return a.sign == MINUS ? -1 : 1;
+    }
+    int c = compare(a.number, b.number);
+    return a.sign == MINUS ? -c : c;
+}
+
+int big_number::compare(const big_number::VL &a, const big_number::VL &b) {
+    if (a.size() == 1 && b.size() == 1) {
+        return a[0] == b[0] ? 0 : a[0] < b[0] ? -1 : 1;
+    }
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
         }
     }
     return 0;
 }
 
-big_number big_number::add_operation(const big_number &a, const big_number &b) {
-    if (a.sign == MINUS && b.sign == MINUS) {
-        return big_number(add(a.number, b.number), MINUS);
-    } else if (a.sign == PLUS && b.sign == MINUS) {
-        SDI result = sub(a.number, b.number);
-        return big_number(result.first, result.second);
-    } else if (a.sign == MINUS && b.sign == PLUS) {
-        SDI result = sub(a.number, b.number);
-        return big_number(result.first, change_sign(result.second));
+void big_number::add_operation(big_number &a, const big_number &b) {
+    accumulate(a, b.number, b.sign);
+}
+
+void big_number::sub_operation(big_number &a, const big_number &b) {
+    accumulate(a, b.number, change_sign(b.sign));
+}
+
+void big_number::mul_operation(big_number &a, const big_number &b) {
+    if (is_small(a.number) && is_small(b.number)) {
+        assign(a.number, (unsigned __int128) to_dlimb(a.number) * to_dlimb(b.number));
     } else {
-        return big_number(add(a.number, b.number));
+        a.number = mul(a.number, b.number);
+    }
+    a.sign = a.sign == b.sign ? PLUS : MINUS;
+    normalize(a);
+}
+
+void big_number::pow_operation(big_number &a, const big_number &b) {
+    if (b.sign == MINUS) {
+        throw "unsupported operation";
+    }
+    a.sign = a.sign == MINUS && mod(b.number, 2) == 1 ? MINUS : PLUS;
+    a.number = pow(a.number, b.number);
+    normalize(a);
+}
+
+void big_number::div_operation(big_number &a, const big_number &b) {
+    if (is_zero(b.number)) {
+        throw "division by zero";
     }
+    a.number = div(a.number, b.number);
+    a.sign = a.sign == b.sign ? PLUS : MINUS;
+    normalize(a);
 }
 
-big_number big_number::sub_operation(const big_number &a, const big_number &b) {
-    if (a.sign == MINUS && b.sign == PLUS) {
-        return big_number(add(a.number, b.number), MINUS);
-    } else if (a.sign == PLUS && b.sign == PLUS) {
-        SDI result = sub(a.number, b.number);
-        return big_number(result.first, result.second);
-    } else if (a.sign == MINUS && b.sign == MINUS) {
-        SDI result = sub(a.number, b.number);
-        return big_number(result.first, change_sign(result.second));
+void big_number::mod_operation(big_number &a, const big_number &b) {
+    if (is_zero(b.number)) {
+        throw "division by zero";
+    }
+    a.number = mod(a.number, b.number);
+    normalize(a);
+}
+
+void big_number::accumulate(big_number &a, const big_number::VL &b, big_number::SIGN s) {
+    if (is_small(a.number) && is_small(b)) {
+        long long x = (long long) to_dlimb(a.number), y = (long long) to_dlimb(b);
+        long long sum = (a.sign == MINUS ? -x : x) + (s == MINUS ? -y : y);
+        a.sign = sum < 0 ? MINUS : PLUS;
+        assign(a.number, sum < 0 ? -sum : sum);
+    } else if (a.sign == s) {
+        add(a.number, b);
+    } else if (compare(a.number, b) >= 0) {
+        sub(a.number, b);
     } else {
-        return big_number(add(a.number, b.number));
+        VL x(b);
+        sub(x, a.number);
+        a.number.swap(x);
+        a.sign = s;
     }
+    normalize(a);
 }
 
-big_number big_number::mul_operation(const big_number &a, const big_number &b) {
-    return a.sign == b.sign ?
-        big_number(mul(a.number, b.number)) : big_number(mul(a.number, b.number), MINUS);
+void big_number::add_product(big_number &a, const big_number &x, const big_number &y, bool negate) {
+    if (is_zero(x.number) || is_zero(y.number)) {
+        return;
+    }
+    SIGN s = (x.sign == y.sign) != negate ? PLUS : MINUS;
+    const VL &u = x.number, &v = y.number;
+    if (std::min(u.size(), v.size()) >= KARATSUBA_THRESHOLD || (!is_zero(a.number) && a.sign != s)) {
+        big_number p(x);
+        mul_operation(p, y);
+        accumulate(a, p.number, s);
+        return;
+    }
+    mul_accumulate(a.number, u, v);
+    a.sign = s;
 }
 
-big_number big_number::pow_operation(const big_number &a, const big_number &b) {
-    if (b.sign < 0) {
-        throw "unsupported operation";
+void big_number::normalize(big_number &a) {
+    if (is_zero(a.number)) {
+        a.sign = PLUS;
+    }
+}
+
+void big_number::trim(big_number::VL &a) {
+    while (a.size() > 1 && a.back() == 0) {
+        a.pop_back();
+    }
+    if (a.empty()) {
+        a.push_back(0);
     }
-    return a.sign == MINUS && mod(b.number, 2) == 1 ?
-        big_number(pow(a.number, b.number), MINUS) : big_number(pow(a.number, b.number));
 }
 
-big_number big_number::div_operation(const big_number &a, const big_number &b) {
-    return a.sign == b.sign ?
-           big_number(div(a.number, b.number)) : big_number(div(a.number, b.number), MINUS);
+bool big_number::is_zero(const big_number::VL &a) {
+    return a.size() == 1 && a[0] == 0;
+}
+
+bool big_number::is_small(const big_number::VL &a) {
+    return a.size() <= 2;
+}
+
+big_number::DLIMB big_number::to_dlimb(const big_number::VL &a) {
+    return a.size() == 1 ? a[0] : (DLIMB) a[1] * BASE + a[0];
+}
+
+void big_number::assign(big_number::VL &a, unsigned __int128 x) {
+    a.clear();
+    do {
+        a.push_back((LIMB) (x % BASE));
+        x /= BASE;
+    } while (x > 0);
 }
 
-big_number big_number::mod_operation(const big_number &a, const big_number &b) {
-    // TODO
-    mod(a.number, b.number);
-    return {};
+big_number::VL big_number::slice(const big_number::VL &a, size_t from, size_t to) {
+    from = std::min(from, a.size());
+    to = std::min(to, a.size());
+    VL s(bump_arena::current());
+    s.insert(s.end(), a.begin() + from, a.begin() + to);
+    trim(s);
+    return s;
 }
 
-big_number::DI big_number::add(const big_number::DI &a, const big_number::DI &b, int shift) {
-    DI s;
-    int carry = 0;
-    auto i = a.end(), j = b.end();
-    i--; j--;
-    for (int k = 0; k < shift; k++) {
-        s.push_front(*i);
-        i--;
+void big_number::add(big_number::VL &a, const big_number::VL &b, size_t shift) {
+    if (is_zero(b)) {
+        return;
     }
-    while (i >= a.begin() && j >= b.begin()) {
-        int sum = (*i) + (*j) + carry;
-        i--; j--;
-        s.push_front(sum % BASE);
-        carry = sum / BASE;
+    if (a.size() < b.size() + shift) {
+        a.resize(b.size() + shift, 0);
     }
-    while (i >= a.begin() || j >= b.begin()) {
-        if (i >= a.begin()) {
-            carry += *i;
-            i--;
-        } else {
-            carry += *j;
-            j--;
+    LIMB carry = limb_kernels::add(a.data() + shift, a.data() + shift, b.data(), b.size());
+    size_t i = shift + b.size();
+    for (; carry && i < a.size(); i++) {
+        carry = ++a[i] == BASE;
+        if (carry) {
+            a[i] = 0;
         }
-        s.push_front(carry % BASE);
-        carry /= BASE;
     }
     if (carry) {
-        s.push_front(carry);
+        a.push_back(carry);
     }
-    return s;
 }
 
-big_number::SDI big_number::sub(const big_number::DI &a, const big_number::DI &b) {
-    if (a.size() < b.size()) {
-        return {sub(b, a).first, MINUS};
+void big_number::sub(big_number::VL &a, const big_number::VL &b) {
+    LIMB borrow = limb_kernels::sub(a.data(), a.data(), b.data(), b.size());
+    size_t i = b.size();
+    for (; borrow && i < a.size(); i++) {
+        borrow = a[i] == 0;
+        a[i] = borrow ? BASE - 1 : a[i] - 1;
     }
-    DI s;
-    int carry = 0;
-    auto i = a.end(), j = b.end();
-    i--; j--;
-    while (j >= b.begin()) {
-        int sum = (*i) - (*j) + carry;
-        if (sum < 0 && i != a.begin()) {
-            sum += BASE;
-            carry = -1;
-        } else {
-            carry = 0;
-        }
-        i--; j--;
-        s.push_front(sum);
+    trim(a);
+}
+
+void big_number::mul(big_number::VL &a, big_number::LIMB b) {
+    DLIMB carry = 0;
+    for (auto &x: a) {
+        DLIMB cur = (DLIMB) x * b + carry;
+        x = (LIMB) (cur % BASE);
+        carry = cur / BASE;
     }
-    while (i >= a.begin()) {
-        int sum = (*i) + carry;
-        if (sum < 0 && i != a.begin()) {
-            sum += BASE;
-            carry = -1;
-        } else {
-            carry = 0;
-        }
-        i--;
-        s.push_front(sum);
+    if (carry) {
+        a.push_back((LIMB) carry);
     }
-    while (*s.begin() == 0 && s.size() > 1) {
-        s.pop_front();
+    trim(a);
+}
+
+big_number::VL big_number::mul(const big_number::VL &a, const big_number::VL &b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t m = std::max(a.size(), b.size());
+    if (n >= PARALLEL_THRESHOLD && MAX_WORKERS > 1 && workers_left == 0) {
+        workers_scope scope(MAX_WORKERS);
+        return mul(a, b);
     }
-    if (s.front() < 0) {
-        s.front() *= -1;
-        return {s, MINUS};
+    if (n < std::max<size_t>(KARATSUBA_THRESHOLD, 2)) {
+        return mul_schoolbook(a, b);
+    } else if (2 * n <= m) {
+        return mul_unbalanced(a, b);
+    } else if (n < std::max<size_t>(TOOM3_THRESHOLD, 3)) {
+        return mul_karatsuba(a, b);
+    } else if (n >= NTT_THRESHOLD && a.size() + b.size() <= NTT_MAX_SIZE) {
+        return mul_ntt(a, b);
     } else {
-        return {s, PLUS};
+        return mul_toom3(a, b);
     }
 }
 
-big_number::DI big_number::mul(const big_number::DI &a, int b) {
-    DI s;
-    int carry = 0;
-    auto i = a.end();
-    i--;
-    while (i >= a.begin()) {
-        long long sum = (long long) (*i) * b + carry;
-        i--;
-        s.push_front(sum % BASE);
-        carry = sum / BASE;
+big_number::VL big_number::mul_schoolbook(const big_number::VL &a, const big_number::VL &b) {
+    VL s(bump_arena::current());
+    s.assign(a.size() + b.size(), 0);
+    mul_accumulate(s, a, b);
+    return s;
+}
+
+void big_number::mul_accumulate(big_number::VL &r, const big_number::VL &a, const big_number::VL &b) {
+    const VL &u = a.size() < b.size() ? a : b;
+    const VL &v = a.size() < b.size() ? b : a;
+    if (r.size() < u.size() + v.size()) {
+        r.resize(u.size() + v.size(), 0);
     }
-    if (carry) {
-        s.push_front(carry);
+    if (v.size() < MUL_KERNEL_SIZE) {
+        for (size_t i = 0; i < u.size(); i++) {
+            DLIMB carry = 0;
+            for (size_t j = 0; j < v.size(); j++) {
+                DLIMB cur = r[i + j] + (DLIMB) u[i] * v[j] + carry;
+                r[i + j] = (LIMB) (cur % BASE);
+                carry = cur / BASE;
+            }
+            for (size_t k = i + v.size(); carry; k++) {
+                if (k == r.size()) {
+                    r.push_back(0);
+                }
+                DLIMB cur = r[k] + carry;
+                r[k] = (LIMB) (cur % BASE);
+                carry = cur / BASE;
+            }
+        }
+        trim(r);
+        return;
     }
+    // rows are accumulated with vector kernel into 64-bit columns, carries are propagated after
+    // every MUL_KERNEL_ROWS rows, before the columns can overflow
+    std::vector<DLIMB> acc(r.begin(), r.end());
+    for (size_t i0 = 0; i0 < u.size(); i0 += MUL_KERNEL_ROWS) {
+        size_t i1 = std::min(u.size(), i0 + MUL_KERNEL_ROWS);
+        for (size_t i = i0; i < i1; i++) {
+            if (u[i] != 0) {
+                limb_kernels::addmul(acc.data() + i, v.data(), v.size(), u[i]);
+            }
+        }
+        DLIMB carry = 0;
+        for (size_t k = i0; k < i1 + v.size() || carry; k++) {
+            if (k == acc.size()) {
+                acc.push_back(0);
+            }
+            DLIMB cur = acc[k] + carry;
+            acc[k] = cur % BASE;
+            carry = cur / BASE;
+        }
+    }
+    r.resize(acc.size());
+    std::copy(acc.begin(), acc.end(), r.begin());
+    trim(r);
+}
+
+big_number::VL big_number::mul_karatsuba(const big_number::VL &a, const big_number::VL &b) {
+    size_t k = std::max(a.size(), b.size()) / 2;
+    VL a0 = slice(a, 0, k), a1 = slice(a, k, a.size());
+    VL b0 = slice(b, 0, k), b1 = slice(b, k, b.size());
+    VL a01(bump_arena::current()), b01(bump_arena::current());
+    a01 = a0;
+    b01 = b0;
+    add(a01, a1);
+    add(b01, b1);
+    VL z0, z1, z2;
+    run_products({[&] { z0 = mul(a0, b0); },
+                  [&] { z1 = mul(a01, b01); },
+                  [&] { z2 = mul(a1, b1); }}, std::min(a.size(), b.size()));
+    sub(z1, z0);
+    sub(z1, z2);
+    add(z0, z1, k);
+    add(z0, z2, 2 * k);
+    return z0;
+}
+
+big_number::VL big_number::mul_toom3(const big_number::VL &a, const big_number::VL &b) {
+    size_t k = (std::max(a.size(), b.size()) + 2) / 3;
+    big_number a0(slice(a, 0, k)), a1(slice(a, k, 2 * k)), a2(slice(a, 2 * k, a.size()));
+    big_number b0(slice(b, 0, k)), b1(slice(b, k, 2 * k)), b2(slice(b, 2 * k, b.size()));
+
+    // evaluation in points 0, 1, -1, -2 and infinity
+    big_number p = a0 + a2, q = b0 + b2;
+    big_number p1 = p + a1, q1 = q + b1;
+    big_number pm1 = p - a1, qm1 = q - b1;
+    big_number pm2 = pm1 + a2, qm2 = qm1 + b2;
+    mul(pm2.number, 2);
+    mul(qm2.number, 2);
+    pm2 -= a0;
+    qm2 -= b0;
+
+    big_number r0, r1, rm1, rm2, rinf;
+    run_products({[&] { r0 = a0 * b0; },
+                  [&] { r1 = p1 * q1; },
+                  [&] { rm1 = pm1 * qm1; },
+                  [&] { rm2 = pm2 * qm2; },
+                  [&] { rinf = a2 * b2; }}, std::min(a.size(), b.size()));
+
+    // interpolation, all divisions are exact
+    big_number c3 = rm2 - r1;
+    div(c3.number, 3);
+    big_number c1 = r1 - rm1;
+    div(c1.number, 2);
+    big_number c2 = rm1 - r0;
+    c3 = c2 - c3;
+    div(c3.number, 2);
+    c3 += rinf;
+    c3 += rinf;
+    c2 += c1;
+    c2 -= rinf;
+    c1 -= c3;
+
+    VL s = std::move(r0.number);
+    add(s, c1.number, k);
+    add(s, c2.number, 2 * k);
+    add(s, c3.number, 3 * k);
+    add(s, rinf.number, 4 * k);
+    trim(s);
+    return s;
+}
+
+big_number::VL big_number::mul_ntt(const big_number::VL &a, const big_number::VL &b) {
+    typedef ntt<469762049, 3> N1;
+    typedef ntt<167772161, 3> N2;
+    typedef ntt<754974721, 11> N3;
+    size_t n = 1;
+    while (n < a.size() + b.size()) {
+        n <<= 1;
+    }
+    std::vector<LIMB> r1, r2, r3;
+    run_products({[&] { r1 = N1::convolve(a, b, n); },
+                  [&] { r2 = N2::convolve(a, b, n); },
+                  [&] { r3 = N3::convolve(a, b, n); }}, std::min(a.size(), b.size()));
+
+    // Garner's algorithm, x = x1 + p1 * t2 + p1 * p2 * t3
+    const DLIMB p1 = N1::MOD, p12 = p1 * N2::MOD;
+    const LIMB inv1 = N2::power(N1::MOD % N2::MOD, N2::MOD - 2);
+    const LIMB inv12 = N3::power((LIMB) (p12 % N3::MOD), N3::MOD - 2);
+    VL s(a.size() + b.size(), 0);
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        LIMB t2 = N2::mul((r2[i] + N2::MOD - r1[i] % N2::MOD) % N2::MOD, inv1);
+        DLIMB x12 = r1[i] + p1 * t2;
+        LIMB t3 = N3::mul((LIMB) ((r3[i] + N3::MOD - x12 % N3::MOD) % N3::MOD), inv12);
+        carry += x12 + (unsigned __int128) p12 * t3;
+        s[i] = (LIMB) (carry % BASE);
+        carry /= BASE;
+    }
+    trim(s);
     return s;
 }
 
-big_number::DI big_number::mul(const big_number::DI &a, const big_number::DI &b) {
-    DI s;
-    s.push_front(0);
-    auto j = b.end();
-    j--;
-    int shift = 0;
-    while (j >= b.begin()) {
-        s = add(s, mul(a, *j), shift++);
-        j--;
+big_number::VL big_number::mul_unbalanced(const big_number::VL &a, const big_number::VL &b) {
+    const VL &l = a.size() < b.size() ? b : a;
+    const VL &r = a.size() < b.size() ? a : b;
+    VL s(bump_arena::current());
+    s.assign(1, 0);
+    if (r.size() < PARALLEL_THRESHOLD || workers_left <= 1) {
+        for (size_t i = 0; i < l.size(); i += r.size()) {
+            add(s, mul(slice(l, i, i + r.size()), r), i);
+        }
+    } else {
+        std::vector<VL> chunks((l.size() + r.size() - 1) / r.size());
+        std::vector<std::function<void()>> products;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            products.push_back([&, c] { chunks[c] = mul(slice(l, c * r.size(), (c + 1) * r.size()), r); });
+        }
+        run_products(products, r.size());
+        for (size_t c = 0; c < chunks.size(); c++) {
+            add(s, chunks[c], c * r.size());
+        }
     }
+    trim(s);
     return s;
 }
 
-big_number::DI big_number::pow(const big_number::DI &a, const big_number::DI &b) {
-    DI s, aa = a, bb = b;
-    s.push_back(1);
-    while (bb.back() != 0) {
-        if (bb.back() % 2 == 1) {
+void big_number::run_products(const std::vector<std::function<void()>> &products, size_t n) {
+    unsigned workers = workers_left;
+    if (workers <= 1 || n < PARALLEL_THRESHOLD || products.size() < 2) {
+        for (auto &product: products) {
+            product();
+        }
+        return;
+    }
+    // at most workers tasks, each runs its share of products and splits its share of workers
+    // among products nested in them, so all of them together never occupy more threads
+    size_t k = std::min<size_t>(workers, products.size());
+    task_pool::TASKS tasks;
+    for (size_t t = 0; t < k; t++) {
+        size_t first = products.size() * t / k, last = products.size() * (t + 1) / k;
+        unsigned share = (unsigned) (workers / k + (t < workers % k));
+        tasks.push_back([&products, first, last, share] {
+            workers_scope scope(share);
+            for (size_t i = first; i < last; i++) {
+                products[i]();
+            }
+        });
+    }
+    shared_pool().run(tasks);
+}
+
+big_number::VL big_number::pow(const big_number::VL &a, const big_number::VL &b) {
+    VL s(1, 1), aa = a, bb = b;
+    while (!is_zero(bb)) {
+        if (div(bb, 2) == 1) {
             s = mul(s, aa);
         }
-        aa = mul(aa, aa);
-        bb = div(bb, 2);
+        if (!is_zero(bb)) {
+            aa = mul(aa, aa);
+        }
     }
     return s;
 }
 
-big_number::DI big_number::div(const big_number::DI &a, int b) {
-    DI s;
-    long long carry = 0;
-    auto i = a.begin();
-    while (i != a.end()) {
-        carry = carry * BASE + (*i);
-        i++;
-        s.push_back(carry / b);
+big_number::LIMB big_number::div(big_number::VL &a, big_number::LIMB b) {
+    DLIMB carry = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        carry = carry * BASE + a[i];
+        a[i] = (LIMB) (carry / b);
         carry %= b;
     }
-    while (*s.begin() == 0 && s.size() > 1) {
-        s.pop_front();
+    trim(a);
+    return (LIMB) carry;
+}
+
+big_number::VL big_number::div(const big_number::VL &a, const big_number::VL &b) {
+    VL q, r;
+    divmod(a, b, q, r);
+    return q;
+}
+
+big_number::LIMB big_number::mod(const big_number::VL &a, big_number::LIMB b) {
+    DLIMB carry = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        carry = (carry * BASE + a[i]) % b;
+    }
+    return (LIMB) carry;
+}
+
+big_number::VL big_number::mod(const big_number::VL &a, const big_number::VL &b) {
+    VL q, r;
+    divmod(a, b, q, r);
+    return r;
+}
+
+void big_number::divmod(const big_number::VL &a, const big_number::VL &b, big_number::VL &q, big_number::VL &r) {
+    if (compare(a, b) < 0) {
+        q.assign(1, 0);
+        r = a;
+    } else if (b.size() == 1) {
+        q = a;
+        r.assign(1, div(q, b[0]));
+    } else if (b.size() < BURNIKEL_ZIEGLER_THRESHOLD || a.size() - b.size() < BURNIKEL_ZIEGLER_THRESHOLD) {
+        div_knuth(a, b, q, r);
+    } else {
+        div_burnikel_ziegler(a, b, q, r);
     }
-    return s;
 }
 
-big_number::DI big_number::div(const big_number::DI &a, const big_number::DI &b) {
-    // TODO
-    return {};
+void big_number::div_knuth(const big_number::VL &a, const big_number::VL &b, big_number::VL &q, big_number::VL &r) {
+    if (compare(a, b) < 0) {
+        q.assign(1, 0);
+        r = a;
+        return;
+    }
+    size_t n = b.size(), m = a.size() - n;
+    // scale both operands so that the top limb of divisor is at least BASE / 2
+    LIMB d = BASE / (b.back() + 1);
+    VL u(bump_arena::current()), v(bump_arena::current());
+    u = a;
+    v = b;
+    mul(u, d);
+    mul(v, d);
+    u.resize(a.size() + 1, 0);
+    q.assign(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0;) {
+        DLIMB num = (DLIMB) u[j + n] * BASE + u[j + n - 1];
+        DLIMB qhat = num / v[n - 1], rhat = num % v[n - 1];
+        while (qhat >= BASE || (n > 1 && qhat * v[n - 2] > rhat * BASE + u[j + n - 2])) {
+            qhat--;
+            rhat += v[n - 1];
+            if (rhat >= BASE) {
+                break;
+            }
+        }
+        DLIMB carry = 0;
+        long long borrow = 0;
+        for (size_t i = 0; i < n; i++) {
+            DLIMB p = qhat * v[i] + carry;
+            carry = p / BASE;
+            long long t = (long long) u[i + j] - (long long) (p % BASE) - borrow;
+            borrow = t < 0;
+            u[i + j] = (LIMB) (borrow ? t + BASE : t);
+        }
+        long long top = (long long) u[j + n] - (long long) carry - borrow;
+        if (top < 0) {
+            // estimate was one too large, add divisor back
+            qhat--;
+            LIMB c = 0;
+            for (size_t i = 0; i < n; i++) {
+                LIMB sum = u[i + j] + v[i] + c;
+                c = sum >= BASE;
+                u[i + j] = c ? sum - BASE : sum;
+            }
+            top += c;
+        }
+        u[j + n] = (LIMB) top;
+        q[j] = (LIMB) qhat;
+    }
+    trim(q);
+    u.resize(n);
+    trim(u);
+    div(u, d);
+    r.swap(u);
+}
+
+void big_number::div_burnikel_ziegler(const big_number::VL &a, const big_number::VL &b, big_number::VL &q,
+                                      big_number::VL &r) {
+    // pad divisor to n = j * 2^k limbs, so that recursion halves it down to blocks below threshold
+    size_t s = b.size();
+    size_t m = 1;
+    while (m * BURNIKEL_ZIEGLER_THRESHOLD <= s) {
+        m <<= 1;
+    }
+    size_t n = (s + m - 1) / m * m;
+    LIMB d = BASE / (b.back() + 1);
+    VL bs(bump_arena::current()), as(bump_arena::current());
+    bs.assign(n - s, 0);
+    as.assign(n - s, 0);
+    bs.insert(bs.end(), b.begin(), b.end());
+    as.insert(as.end(), a.begin(), a.end());
+    mul(bs, d);
+    mul(as, d);
+
+    // split dividend into t blocks of n limbs, the top block has to be smaller than divisor
+    size_t t = std::max<size_t>(2, (as.size() + n) / n);
+    VL z = slice(as, (t - 2) * n, t * n);
+    q.assign(1, 0);
+    for (size_t i = t - 1; i-- > 0;) {
+        VL qi(bump_arena::current()), ri(bump_arena::current());
+        div_2n1n(z, bs, n, qi, ri);
+        add(q, qi, i * n);
+        if (i > 0) {
+            z = slice(as, (i - 1) * n, i * n);
+            add(z, ri, n);
+        } else {
+            r = slice(ri, n - s, ri.size());
+            div(r, d);
+        }
+    }
+    trim(q);
+}
+
+void big_number::div_2n1n(const big_number::VL &a, const big_number::VL &b, size_t n, big_number::VL &q,
+                          big_number::VL &r) {
+    if (n % 2 == 1 || n < BURNIKEL_ZIEGLER_THRESHOLD) {
+        div_knuth(a, b, q, r);
+        return;
+    }
+    size_t h = n / 2;
+    VL q1(bump_arena::current()), r1(bump_arena::current());
+    div_3n2n(slice(a, h, 4 * h), b, h, q1, r1);
+    VL x = slice(a, 0, h);
+    add(x, r1, h);
+    div_3n2n(x, b, h, q, r);
+    add(q, q1, h);
+}
+
+void big_number::div_3n2n(const big_number::VL &a, const big_number::VL &b, size_t h, big_number::VL &q,
+                          big_number::VL &r) {
+    VL a12 = slice(a, h, 3 * h);
+    VL b1 = slice(b, h, 2 * h);
+    VL r1(bump_arena::current());
+    if (compare(slice(a, 2 * h, 3 * h), b1) < 0) {
+        div_2n1n(a12, b1, h, q, r1);
+    } else {
+        // quotient is BASE^h - 1 and r1 = a12 - b1 * BASE^h + b1
+        q.assign(h, BASE - 1);
+        r1 = a12;
+        add(r1, b1);
+        VL x(bump_arena::current());
+        x.assign(h, 0);
+        x.insert(x.end(), b1.begin(), b1.end());
+        sub(r1, x);
+    }
+    VL x = slice(a, 0, h);
+    add(x, r1, h);
+    VL dd = mul(q, slice(b, 0, h));
+    VL one(1, 1);
+    while (compare(x, dd) < 0) {
+        add(x, b);
+        sub(q, one);
+    }
+    sub(x, dd);
+    r.swap(x);
+}
+
+std::vector<bool> big_number::bits(const big_number::VL &a) {
+    std::vector<bool> result;
+    for (uint32_t w: to_words(a)) {
+        for (int i = 0; i < 32; i++) {
+            result.push_back((w >> i) & 1);
+        }
+    }
+    while (!result.empty() && !result.back()) {
+        result.pop_back();
+    }
+    return result;
+}
+
+std::vector<uint32_t> big_number::to_words(const big_number::VL &a) {
+    std::vector<VL> pows(1, VL{294967296, 4});
+    while (compare(pows.back(), a) <= 0) {
+        pows.push_back(mul(pows.back(), pows.back()));
+    }
+    std::vector<uint32_t> out;
+    to_words(a, pows, pows.size() - 1, out);
+    while (!out.empty() && out.back() == 0) {
+        out.pop_back();
+    }
+    return out;
+}
+
+void big_number::to_words(const big_number::VL &a, const std::vector<VL> &pows, size_t k,
+                          std::vector<uint32_t> &out) {
+    // appends exactly 2^k words, a < pows[k]
+    if (k == 0 || a.size() <= RADIX_LEAF_SIZE) {
+        VL x(a);
+        size_t end = out.size() + ((size_t) 1 << k);
+        while (!is_zero(x)) {
+            uint32_t lo = div(x, 1 << 16);
+            uint32_t hi = div(x, 1 << 16);
+            out.push_back(hi << 16 | lo);
+        }
+        out.resize(end, 0);
+        return;
+    }
+    VL hi, lo;
+    divmod(a, pows[k - 1], hi, lo);
+    to_words(lo, pows, k - 1, out);
+    to_words(hi, pows, k - 1, out);
+}
+
+big_number::VL big_number::from_words(const std::vector<uint32_t> &w) {
+    std::vector<VL> blocks;
+    for (uint32_t x: w) {
+        blocks.emplace_back();
+        assign(blocks.back(), x);
+    }
+    if (blocks.empty()) {
+        return VL(1, 0);
+    }
+    // same joining as in from_radix, block on level k holds 2^k words
+    VL p{294967296, 4};
+    while (blocks.size() > 1) {
+        std::vector<VL> joined;
+        for (size_t j = 0; j + 1 < blocks.size(); j += 2) {
+            VL x = mul(blocks[j + 1], p);
+            add(x, blocks[j]);
+            joined.push_back(std::move(x));
+        }
+        if (blocks.size() % 2 == 1) {
+            joined.push_back(std::move(blocks.back()));
+        }
+        blocks.swap(joined);
+        if (blocks.size() > 1) {
+            p = mul(p, p);
+        }
+    }
+    return blocks[0];
+}
+
+big_number::VL big_number::shift_left(const big_number::VL &a, size_t k) {
+    VL e;
+    assign(e, k);
+    return mul(a, pow(VL(1, 2), e));
+}
+
+big_number big_number::bitwise(const big_number &a, const big_number &b, char op) {
+    std::vector<uint32_t> x = to_words(a.number), y = to_words(b.number);
+    // one more word keeps sign bit of both representations
+    size_t n = std::max(x.size(), y.size()) + 1;
+    std::vector<uint32_t> *v[] = {&x, &y};
+    bool negative[] = {a.sign == MINUS, b.sign == MINUS};
+    for (int i = 0; i < 2; i++) {
+        v[i]->resize(n, 0);
+        if (negative[i]) {
+            // -m = ~m + 1
+            uint64_t carry = 1;
+            for (auto &w: *v[i]) {
+                carry += (uint32_t) ~w;
+                w = (uint32_t) carry;
+                carry >>= 32;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        x[i] = op == '&' ? x[i] & y[i] : op == '|' ? x[i] | y[i] : x[i] ^ y[i];
+    }
+    bool minus = x.back() >> 31;
+    if (minus) {
+        uint64_t carry = 1;
+        for (auto &w: x) {
+            carry += (uint32_t) ~w;
+            w = (uint32_t) carry;
+            carry >>= 32;
+        }
+    }
+    while (!x.empty() && x.back() == 0) {
+        x.pop_back();
+    }
+    big_number r(from_words(x), minus ? MINUS : PLUS);
+    normalize(r);
+    return r;
+}
+
+big_number::VL big_number::gcd(big_number::VL a, big_number::VL b) {
+    if (compare(a, b) < 0) {
+        a.swap(b);
+    }
+    while (!is_zero(b)) {
+        if (is_small(a)) {
+            DLIMB x = to_dlimb(a), y = to_dlimb(b);
+            while (y != 0) {
+                DLIMB t = x % y;
+                x = y;
+                y = t;
+            }
+            assign(a, x);
+            return a;
+        }
+        // leading two limbs of a and limbs of b at the same positions, both below 10^18
+        size_t n = a.size();
+        long long ah = (long long) a[n - 1] * BASE + a[n - 2];
+        long long bh = (n - 1 < b.size() ? (long long) b[n - 1] * BASE : 0) + (n - 2 < b.size() ? b[n - 2] : 0);
+        long long A = 1, B = 0, C = 0, D = 1;
+        while (bh + C > 0 && bh + D > 0) {
+            long long q = (ah + A) / (bh + C);
+            if (q != (ah + B) / (bh + D) || q >= LEHMER_COFACTOR) {
+                break;
+            }
+            long long c = A - q * C, d = B - q * D;
+            if (std::max(std::abs(c), std::abs(d)) >= LEHMER_COFACTOR) {
+                break;
+            }
+            A = C;
+            C = c;
+            B = D;
+            D = d;
+            long long t = ah - q * bh;
+            ah = bh;
+            bh = t;
+        }
+        if (B == 0) {
+            VL r = mod(a, b);
+            a.swap(b);
+            b.swap(r);
+        } else {
+            lincomb(a, b, A, B, C, D);
+        }
+    }
+    return a;
+}
+
+void big_number::lincomb(big_number::VL &a, big_number::VL &b, long long x, long long y, long long z,
+                         long long w) {
+    size_t n = std::max(a.size(), b.size());
+    a.resize(n, 0);
+    b.resize(n, 0);
+    long long c1 = 0, c2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        long long u = a[i], v = b[i];
+        long long t1 = x * u + y * v + c1, t2 = z * u + w * v + c2;
+        c1 = t1 / (long long) BASE;
+        c2 = t2 / (long long) BASE;
+        t1 -= c1 * (long long) BASE;
+        t2 -= c2 * (long long) BASE;
+        if (t1 < 0) {
+            t1 += BASE;
+            c1--;
+        }
+        if (t2 < 0) {
+            t2 += BASE;
+            c2--;
+        }
+        a[i] = (LIMB) t1;
+        b[i] = (LIMB) t2;
+    }
+    for (; c1 > 0; c1 /= BASE) {
+        a.push_back((LIMB) (c1 % BASE));
+    }
+    for (; c2 > 0; c2 /= BASE) {
+        b.push_back((LIMB) (c2 % BASE));
+    }
+    trim(a);
+    trim(b);
+}
+
+big_number::VL big_number::isqrt(const big_number::VL &a) {
+    if (is_small(a)) {
+        DLIMB x = to_dlimb(a);
+        DLIMB s = (DLIMB) std::sqrt((long double) x);
+        while (s * s > x) {
+            s--;
+        }
+        while ((s + 1) * (s + 1) <= x) {
+            s++;
+        }
+        VL r;
+        assign(r, s);
+        return r;
+    }
+    // x0 = (isqrt(a / BASE^2k) + 1) * BASE^k >= sqrt(a) has half of the digits right,
+    // Newton's iterations from above decrease to the result in a few steps
+    size_t k = std::max<size_t>(1, a.size() / 4);
+    VL s = isqrt(slice(a, 2 * k, a.size()));
+    add(s, VL(1, 1));
+    VL x(1, 0);
+    add(x, s, k);
+    while (true) {
+        VL y = div(a, x);
+        add(y, x);
+        div(y, 2);
+        if (compare(y, x) >= 0) {
+            return x;
+        }
+        x.swap(y);
+    }
+}
+
+big_number::montgomery_context::montgomery_context(const big_number &m) : m(m.number), m_inv(0) {
+    if (m.sign == MINUS || is_zero(m.number)) {
+        throw "modulus has to be positive";
+    }
+    montgomery = m.number[0] % 2 != 0 && m.number[0] % 5 != 0;
+    if (montgomery) {
+        // m_inv = -m^-1 mod BASE, from extended Euclid's algorithm
+        long long r0 = BASE, r1 = this->m[0], t0 = 0, t1 = 1;
+        while (r1 != 0) {
+            long long q = r0 / r1, r = r0 - q * r1, t = t0 - q * t1;
+            r0 = r1;
+            r1 = r;
+            t0 = t1;
+            t1 = t;
+        }
+        t0 %= (long long) BASE;
+        m_inv = (LIMB) (t0 == 0 ? 0 : t0 > 0 ? BASE - t0 : -t0);
+        VL r(2 * this->m.size() + 1, 0);
+        r.back() = 1;
+        r2 = mod(r, this->m);
+    }
+    one = _to_form(VL(1, 1));
+}
+
+big_number big_number::montgomery_context::modulus() const {
+    return big_number(m);
+}
+
+big_number big_number::montgomery_context::pow(const big_number &base, const big_number &exp) const {
+    if (exp.sign == MINUS) {
+        throw "unsupported operation";
+    }
+    VL b = mod(base.number, m);
+    if (base.sign == MINUS && !is_zero(b)) {
+        VL x(m);
+        sub(x, b);
+        b.swap(x);
+    }
+    std::vector<bool> e = bits(exp.number);
+    size_t w = e.size() > 2048 ? 6 : e.size() > 512 ? 5 : e.size() > 128 ? 4 : e.size() > 16 ? 3 : 1;
+
+    // odd powers b, b^3, ..., b^(2^w - 1) in Montgomery form
+    std::vector<VL> table(1, _to_form(b));
+    VL b2 = _mul(table[0], table[0]);
+    for (size_t i = 1; i < ((size_t) 1 << (w - 1)); i++) {
+        table.push_back(_mul(table[i - 1], b2));
+    }
+
+    VL acc = one;
+    for (size_t i = e.size(); i-- > 0;) {
+        if (!e[i]) {
+            acc = _mul(acc, acc);
+            continue;
+        }
+        size_t l = i + 1 > w ? i + 1 - w : 0;
+        while (!e[l]) {
+            l++;
+        }
+        size_t value = 0;
+        for (size_t j = i + 1; j-- > l;) {
+            value = value << 1 | e[j];
+            acc = _mul(acc, acc);
+        }
+        acc = _mul(acc, table[value >> 1]);
+        i = l;
+    }
+    return big_number(_from_form(acc));
+}
+
+big_number::VL big_number::montgomery_context::_redc(big_number::VL t) const {
+    size_t n = m.size();
+    t.resize(2 * n + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        DLIMB u = (DLIMB) t[i] * m_inv % BASE;
+        DLIMB carry = 0;
+        for (size_t j = 0; j < n; j++) {
+            DLIMB cur = t[i + j] + u * m[j] + carry;
+            t[i + j] = (LIMB) (cur % BASE);
+            carry = cur / BASE;
+        }
+        for (size_t k = i + n; carry; k++) {
+            DLIMB cur = t[k] + carry;
+            t[k] = (LIMB) (cur % BASE);
+            carry = cur / BASE;
+        }
+    }
+    VL r(t.begin() + n, t.end());
+    trim(r);
+    if (compare(r, m) >= 0) {
+        sub(r, m);
+    }
+    return r;
+}
+
+big_number::VL big_number::montgomery_context::_mul(const big_number::VL &a, const big_number::VL &b) const {
+    return montgomery ? _redc(big_number::mul(a, b)) : mod(big_number::mul(a, b), m);
 }
 
-int big_number::mod(const big_number::DI &a, int b) {
-    return a.back() % b;
+big_number::VL big_number::montgomery_context::_to_form(const big_number::VL &a) const {
+    return montgomery ? _mul(a, r2) : mod(a, m);
 }
 
-big_number::DI big_number::mod(const big_number::DI &a, const big_number::DI &b) {
-    // TODO
-    return {};
+big_number::VL big_number::montgomery_context::_from_form(const big_number::VL &a) const {
+    return montgomery ? _redc(a) : a;
 }
@@ -7,8 +7,20 @@
 #define ALGORITHMS_BIG_NUMBER_H
 
 
-#include <deque>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "small_vector.h"
+
+template<typename T>
+struct expr_traits;
+template<typename L, typename R, bool NEG>
+class sum_expr;
+template<typename L, typename R>
+class product_expr;
 
 class big_number {
 
@@ -19,12 +31,37 @@ private:
     };
 
     typedef std::string STR;
-    typedef std::deque<int> DI;
-    typedef std::pair<DI, SIGN> SDI;
+    typedef uint32_t LIMB;
+    typedef uint64_t DLIMB;
+    /**
+     * contiguous limbs in base BASE, little-endian (number[0] is the least significant limb),
+     * never empty and without leading zero limbs, zero is {0} with sign PLUS,
+     * up to INLINE_LIMBS limbs (every 128-bit value) are stored without heap allocation
+     */
+    static const size_t INLINE_LIMBS = 5;
+    typedef small_vector<LIMB, INLINE_LIMBS> VL;
+    typedef std::pair<VL, SIGN> SVL;
 
-    static const int BASE = 1e9;
+    static const LIMB BASE = 1000000000;
+    /**
+     * longest product (in limbs) that fits into three-prime NTT,
+     * larger products are split by Toom-3 first
+     */
+    static const size_t NTT_MAX_SIZE = 1 << 24;
+    /**
+     * shortest row handed to multiply-accumulate kernel and number of rows
+     * which 64-bit columns can take before carries have to be propagated
+     */
+    static const size_t MUL_KERNEL_SIZE = 8;
+    static const size_t MUL_KERNEL_ROWS = 18;
+    /**
+     * batch operations work on tiles of BATCH_LANES numbers stored as structure of arrays
+     * (limb j of all numbers in one row), operands longer than BATCH_LIMBS go one by one
+     */
+    static const size_t BATCH_LANES = 64;
+    static const size_t BATCH_LIMBS = 4;
 
-    DI number;
+    VL number;
     SIGN sign;
 
 public:
@@ -32,41 +69,285 @@ public:
     big_number();
     explicit big_number(int a);
     explicit big_number(const STR& s, int base = 10);
-    
+
+    /**
+     * evaluates expression built from +, - and * into preallocated limbs in one pass
+     */
+    template<typename E, typename = typename std::enable_if<expr_traits<E>::is_node>::type>
+    big_number(const E& e);
+
+    template<typename E, typename = typename std::enable_if<expr_traits<E>::is_node>::type>
+    big_number& operator=(const E& e);
+
+    /**
+     * sizes of smaller operand (in limbs) from which multiplication switches
+     * from schoolbook to Karatsuba, from Karatsuba to Toom-3 and from Toom-3 to NTT,
+     * can be calibrated per machine
+     */
+    static size_t KARATSUBA_THRESHOLD;
+    static size_t TOOM3_THRESHOLD;
+    static size_t NTT_THRESHOLD;
+    /**
+     * size of divisor (in limbs) from which division switches
+     * from Knuth's algorithm D to Burnikel-Ziegler recursive division
+     */
+    static size_t BURNIKEL_ZIEGLER_THRESHOLD;
+    /**
+     * size of smaller operand (in limbs) from which sub-products of multiplication
+     * run in parallel, and number of threads they can use (1 disables threads),
+     * threads are started once, by the first parallel multiplication
+     */
+    static size_t PARALLEL_THRESHOLD;
+    static unsigned MAX_WORKERS;
+
+    class montgomery_context;
+    class view;
+
+    /**
+     * binary format: limb count (uint64), sign (uint32, 1 for negative numbers)
+     * and limbs (uint32) least significant first, all in byte order of this machine
+     */
+    size_t binary_size() const;
+    void write(std::ostream& out) const;
+    /**
+     * throws if data in stream is not a valid number
+     * time complexity: O(n)
+     */
+    static big_number read(std::istream& in);
+
+    /**
+     * compound operators work in place on limbs of this number
+     */
     big_number& operator+=(const big_number& a);
     big_number& operator-=(const big_number& a);
     big_number& operator*=(const big_number& a);
     big_number& operator^=(const big_number& a);
     big_number& operator/=(const big_number& a);
     big_number& operator%=(const big_number& a);
-    
+    /**
+     * shifts by k bits, a << k = a * 2^k and a >> k = floor(a / 2^k)
+     */
+    big_number& operator<<=(size_t k);
+    big_number& operator>>=(size_t k);
+
+    /**
+     * expressions are accumulated straight into this number
+     */
+    template<typename E, typename = typename std::enable_if<expr_traits<E>::is_node>::type>
+    big_number& operator+=(const E& e);
+
+    template<typename E, typename = typename std::enable_if<expr_traits<E>::is_node>::type>
+    big_number& operator-=(const E& e);
+
 private:
 
-    explicit big_number(DI a, SIGN s = PLUS);
+    explicit big_number(VL a, SIGN s = PLUS);
 
     static SIGN change_sign(const SIGN& sign);
 
-    static SDI from_string(const STR& s, int base = 10);
-    static STR to_string(const SDI& a, int base = 10);
+    /**
+     * size (in limbs) below which radix conversion divides by a single limb
+     * instead of splitting number with cached powers of base
+     */
+    static const size_t RADIX_LEAF_SIZE = 32;
+
+    static SVL from_string(const STR& s, int base = 10);
+    static STR to_string(const VL& a, SIGN s, int base = 10);
+
+    /**
+     * base 10 conversions, nine decimal digits map directly onto one limb
+     * time complexity: O(n)
+     */
+    static VL from_decimal(const STR& s, size_t begin);
+    static void to_decimal(const VL& a, STR& out);
+
+    /**
+     * divide and conquer conversions for other bases,
+     * pows[k] = base^(c * 2^k) where base^c is the greatest power of base below BASE
+     * time complexity: O(M(n) log n)
+     */
+    static VL from_radix(const STR& s, size_t begin, int base);
+    static void to_radix(const VL& a, const std::vector<VL>& pows, size_t k, bool pad, int base, size_t c, STR& out);
+
+    /**
+     * @return number c of digits in base which fit into a limb, chunk = base^c
+     */
+    static size_t radix_chunk(int base, LIMB& chunk);
+    static LIMB digit_value(char c);
+    static char digit_char(LIMB x);
 
     static int compare(const big_number& a, const big_number& b);
+    static int compare(const VL& a, const VL& b);
+
+    /**
+     * size of binary header and check of limbs read from outside
+     */
+    static const size_t BINARY_HEADER = sizeof(uint64_t) + sizeof(uint32_t);
+    static void check_binary(const LIMB* a, size_t n, uint32_t s);
 
-    static big_number add_operation(const big_number& a, const big_number& b);
-    static big_number sub_operation(const big_number& a, const big_number& b);
-    static big_number mul_operation(const big_number& a, const big_number& b);
-    static big_number pow_operation(const big_number& a, const big_number& b);
-    static big_number div_operation(const big_number& a, const big_number& b);
-    static big_number mod_operation(const big_number& a, const big_number& b);
-
-    static DI add(const DI& a, const DI& b, int shift = 0);
-    static SDI sub(const DI& a, const DI& b);
-    static DI mul(const DI& a, int b);
-    static DI mul(const DI& a, const DI& b);
-    static DI pow(const DI& a, const DI& b);
-    static DI div(const DI& a, int b);
-    static DI div(const DI& a, const DI& b);
-    static int mod(const DI& a, int b);
-    static DI mod(const DI& a, const DI& b);
+    static void add_operation(big_number& a, const big_number& b);
+    static void sub_operation(big_number& a, const big_number& b);
+    static void mul_operation(big_number& a, const big_number& b);
+    static void pow_operation(big_number& a, const big_number& b);
+    static void div_operation(big_number& a, const big_number& b);
+    static void mod_operation(big_number& a, const big_number& b);
+
+    /**
+     * adds magnitude b with sign s to a in place
+     */
+    static void accumulate(big_number& a, const VL& b, SIGN s);
+
+    /**
+     * adds product x * y (or its negation) to a in place, products of small operands
+     * are accumulated straight into limbs of a without temporary
+     */
+    static void add_product(big_number& a, const big_number& x, const big_number& y, bool negate);
+
+    /**
+     * r[i] = a[i] + b[i] (or a[i] - b[i]) for a tile of lanes, limbs are summed with signs
+     * and signed carries are resolved row by row across all lanes at once
+     */
+    static void sum_tile(const big_number* a, const big_number* b, big_number* r, const size_t* lanes, size_t k,
+                         bool negate);
+    static void mul_tile(const big_number* a, const big_number* b, big_number* r, const size_t* lanes, size_t k);
+    /**
+     * r[i] = op(a[i], b[i]) for i < n, tiles of small operands go to tile, the rest to op
+     */
+    template<typename TILE, typename OP>
+    static void batch(const big_number* a, const big_number* b, big_number* r, size_t n, TILE tile, OP op);
+
+    /**
+     * makes sure that zero is always stored with sign PLUS
+     */
+    static void normalize(big_number& a);
+
+    /**
+     * removes leading zero limbs, leaves at least one limb
+     */
+    static void trim(VL& a);
+    static bool is_zero(const VL& a);
+    /**
+     * fast paths for operands of at most two limbs (values below 10^18)
+     */
+    static bool is_small(const VL& a);
+    static DLIMB to_dlimb(const VL& a);
+    static void assign(VL& a, unsigned __int128 x);
+    /**
+     * @return trimmed limbs [from, to) of a, zero if range is empty
+     */
+    static VL slice(const VL& a, size_t from, size_t to);
+
+    /**
+     * a += b * BASE^shift
+     */
+    static void add(VL& a, const VL& b, size_t shift = 0);
+    /**
+     * a -= b, requires a >= b
+     */
+    static void sub(VL& a, const VL& b);
+    static void mul(VL& a, LIMB b);
+    /**
+     * dispatches multiplication to algorithm suitable for sizes of operands
+     */
+    static VL mul(const VL& a, const VL& b);
+    /**
+     * time complexity: O(n*m)
+     */
+    static VL mul_schoolbook(const VL& a, const VL& b);
+    /**
+     * r += a * b, schoolbook with deferred carries on top of SIMD limb kernels
+     * time complexity: O(n*m)
+     */
+    static void mul_accumulate(VL& r, const VL& a, const VL& b);
+    /**
+     * time complexity: O(n^1.59)
+     */
+    static VL mul_karatsuba(const VL& a, const VL& b);
+    /**
+     * time complexity: O(n^1.47)
+     */
+    static VL mul_toom3(const VL& a, const VL& b);
+    /**
+     * multiplies using NTT modulo three primes, exact coefficients are recovered with CRT
+     * time complexity: O(n log n)
+     */
+    static VL mul_ntt(const VL& a, const VL& b);
+    /**
+     * splits longer operand into chunks of the size of shorter one
+     */
+    static VL mul_unbalanced(const VL& a, const VL& b);
+    /**
+     * runs independent sub-products of multiplication with operands of size n,
+     * on task pool bound to this thread if they are large enough
+     */
+    static void run_products(const std::vector<std::function<void()>>& products, size_t n);
+    static VL pow(const VL& a, const VL& b);
+    /**
+     * a /= b
+     * @return remainder
+     */
+    static LIMB div(VL& a, LIMB b);
+    static VL div(const VL& a, const VL& b);
+    static LIMB mod(const VL& a, LIMB b);
+    static VL mod(const VL& a, const VL& b);
+    /**
+     * computes quotient q and remainder r of a / b, b has to be non zero
+     */
+    static void divmod(const VL& a, const VL& b, VL& q, VL& r);
+    /**
+     * Knuth's algorithm D
+     * time complexity: O(n*m)
+     */
+    static void div_knuth(const VL& a, const VL& b, VL& q, VL& r);
+    /**
+     * Burnikel-Ziegler recursive division, O(M(n) log n) for quotients of size n
+     */
+    static void div_burnikel_ziegler(const VL& a, const VL& b, VL& q, VL& r);
+    /**
+     * divides a < b * BASE^n by normalized b of n limbs
+     */
+    static void div_2n1n(const VL& a, const VL& b, size_t n, VL& q, VL& r);
+    /**
+     * divides a < b * BASE^h by normalized b of 2h limbs
+     */
+    static void div_3n2n(const VL& a, const VL& b, size_t h, VL& q, VL& r);
+
+    /**
+     * @return bits of a, least significant first
+     */
+    static std::vector<bool> bits(const VL& a);
+    /**
+     * conversions to and from base 2^32 words (least significant first),
+     * divide and conquer with pows[k] = 2^(32 * 2^k) like radix conversions
+     * time complexity: O(M(n) log n)
+     */
+    static std::vector<uint32_t> to_words(const VL& a);
+    static void to_words(const VL& a, const std::vector<VL>& pows, size_t k, std::vector<uint32_t>& out);
+    static VL from_words(const std::vector<uint32_t>& w);
+    /**
+     * a * 2^k
+     */
+    static VL shift_left(const VL& a, size_t k);
+    /**
+     * applies op ('&', '|' or '^') to infinite two's complement representations of a and b
+     */
+    static big_number bitwise(const big_number& a, const big_number& b, char op);
+
+    /**
+     * Lehmer's algorithm, quotients are simulated on two leading limbs
+     * and applied to full numbers at once as linear combination
+     */
+    static VL gcd(VL a, VL b);
+    /**
+     * (a, b) = (x * a + y * b, z * a + w * b) in one pass, both results have to be non negative
+     * and coefficients below LEHMER_COFACTOR, so that every column fits into 64 bits
+     */
+    static const long long LEHMER_COFACTOR = 1LL << 31;
+    static void lincomb(VL& a, VL& b, long long x, long long y, long long z, long long w);
+    /**
+     * square root of upper half of limbs refined with Newton's iterations
+     */
+    static VL isqrt(const VL& a);
 
     friend std::istream& operator>>(std::istream& in, big_number& a);
     friend std::ostream& operator<<(std::ostream& out, big_number& a);
@@ -74,16 +355,31 @@ private:
     friend STR to_string(const big_number&, int);
     friend bool compare(const big_number&, const big_number&);
     friend big_number abs(const big_number&);
-    
+    friend std::pair<big_number, big_number> divmod(const big_number&, const big_number&);
+    friend big_number multiply(const big_number&, const big_number&, unsigned);
+    friend void add_batch(const big_number*, const big_number*, big_number*, size_t);
+    friend void sub_batch(const big_number*, const big_number*, big_number*, size_t);
+    friend void mul_batch(const big_number*, const big_number*, big_number*, size_t);
+
     friend big_number operator+(const big_number& a);
     friend big_number operator-(const big_number& a);
 
-    friend big_number operator+(const big_number& a, const big_number& b);
-    friend big_number operator-(const big_number& a, const big_number& b);
-    friend big_number operator*(const big_number& a, const big_number& b);
+    template<typename T>
+    friend struct expr_traits;
+    template<typename L, typename R>
+    friend class product_expr;
+
     friend big_number operator^(const big_number& a, const big_number& b);
     friend big_number operator/(const big_number& a, const big_number& b);
     friend big_number operator%(const big_number& a, const big_number& b);
+    friend big_number operator<<(const big_number& a, size_t k);
+    friend big_number operator>>(const big_number& a, size_t k);
+
+    friend big_number gcd(const big_number&, const big_number&);
+    friend big_number isqrt(const big_number&);
+    friend big_number bitwise_and(const big_number&, const big_number&);
+    friend big_number bitwise_or(const big_number&, const big_number&);
+    friend big_number bitwise_xor(const big_number&, const big_number&);
 
     friend bool operator==(const big_number& a, const big_number& b);
     friend bool operator!=(const big_number& a, const big_number& b);
@@ -98,4 +394,143 @@ std::string to_string(const big_number& a, int base = 10);
 bool compare(const big_number& a, const big_number& b);
 big_number abs(const big_number& a);
 
+/**
+ * @return quotient rounded towards zero and remainder with sign of a, computed in one pass
+ */
+std::pair<big_number, big_number> divmod(const big_number& a, const big_number& b);
+
+/**
+ * @return base ^ exp mod m in range [0, m), m has to be positive
+ * for repeated exponentiations under the same modulus use big_number::montgomery_context
+ */
+big_number pow_mod(const big_number& base, const big_number& exp, const big_number& m);
+
+/**
+ * @return greatest common divisor of |a| and |b|, gcd(0, 0) = 0
+ * time complexity: O(n^2)
+ */
+big_number gcd(const big_number& a, const big_number& b);
+
+/**
+ * @return floor(sqrt(a)), a has to be non negative
+ * time complexity: O(M(n) log n)
+ */
+big_number isqrt(const big_number& a);
+
+/**
+ * bitwise operations on infinite two's complement representations (negative numbers
+ * have infinitely many leading ones), ^ is taken by power so xor has a name too
+ * time complexity: O(M(n) log n)
+ */
+big_number bitwise_and(const big_number& a, const big_number& b);
+big_number bitwise_or(const big_number& a, const big_number& b);
+big_number bitwise_xor(const big_number& a, const big_number& b);
+
+/**
+ * @return a * b computed by at most workers threads (instead of big_number::MAX_WORKERS)
+ */
+big_number multiply(const big_number& a, const big_number& b, unsigned workers);
+
+/**
+ * r[i] = a[i] + b[i], a[i] - b[i] or a[i] * b[i] for i < n,
+ * r may be the same array as a or b (but must not overlap them partially),
+ * operands of up to 36 digits are processed in tiles in structure of arrays layout,
+ * which keeps the loops over a tile vectorizable and results in inline limbs
+ * time complexity: O(n) for small operands
+ */
+void add_batch(const big_number* a, const big_number* b, big_number* r, size_t n);
+void sub_batch(const big_number* a, const big_number* b, big_number* r, size_t n);
+void mul_batch(const big_number* a, const big_number* b, big_number* r, size_t n);
+
+/**
+ * precomputed data for modular exponentiation under fixed modulus,
+ * multiplication uses Montgomery reduction when modulus is coprime to 10 (to limb base)
+ * and plain division otherwise
+ */
+class big_number::montgomery_context {
+
+public:
+
+    /**
+     * precomputes constants for given modulus
+     * time complexity: O(M(n) log n)
+     */
+    explicit montgomery_context(const big_number& m);
+
+    /**
+     * @return modulus of this context
+     */
+    big_number modulus() const;
+
+    /**
+     * @return base ^ exp mod modulus using sliding window exponentiation
+     * time complexity: O(n^2 * log exp)
+     */
+    big_number pow(const big_number& base, const big_number& exp) const;
+
+private:
+
+    VL m;
+    LIMB m_inv;
+    VL r2;
+    VL one;
+    bool montgomery;
+
+    /**
+     * Montgomery reduction, t < m * R
+     * @return t / R mod m
+     */
+    VL _redc(VL t) const;
+    VL _mul(const VL& a, const VL& b) const;
+    VL _to_form(const VL& a) const;
+    VL _from_form(const VL& a) const;
+};
+
+/**
+ * read-only number in binary format of big_number::write wrapped without copying,
+ * e.g. inside memory mapped file, data has to outlive the view
+ */
+class big_number::view {
+
+public:
+
+    /**
+     * checks number at the beginning of data, throws if it is not valid,
+     * data has to be aligned to 4 bytes
+     * time complexity: O(n)
+     */
+    view(const void* data, size_t size);
+
+    /**
+     * @return number of limbs
+     */
+    size_t size() const;
+
+    /**
+     * @return limbs in base 10^9, least significant first
+     */
+    const uint32_t* limbs() const;
+
+    bool negative() const;
+
+    /**
+     * @return bytes taken by wrapped number, next number in buffer starts there
+     */
+    size_t binary_size() const;
+
+    /**
+     * @return copy of wrapped number
+     * time complexity: O(n)
+     */
+    big_number value() const;
+
+private:
+
+    const LIMB* a;
+    size_t n;
+    SIGN sign;
+};
+
+#include "big_number_expr.h"
+
 #endif //ALGORITHMS_BIG_NUMBER_H
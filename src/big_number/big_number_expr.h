@@ -0,0 +1,195 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_BIG_NUMBER_EXPR_H
+#define ALGORITHMS_BIG_NUMBER_EXPR_H
+
+#include <algorithm>
+#include <type_traits>
+#include "big_number.h"
+
+/**
+ * lazy expressions of big_numbers built by binary +, - and *
+ * whole chain like a * b + c * d - e is evaluated once into preallocated output,
+ * sums are accumulated in place and products of small operands are multiplied
+ * straight into output limbs
+ *
+ * expressions keep references to their big_number operands,
+ * so they should not outlive the full expression they are created in (do not store them in auto variables)
+ */
+
+template<typename T>
+struct expr_traits {
+    static const bool is_operand = false;
+    static const bool is_node = false;
+};
+
+template<>
+struct expr_traits<big_number> {
+    static const bool is_operand = true;
+    static const bool is_node = false;
+    typedef const big_number &stored;
+
+    static size_t size_hint(const big_number &a) {
+        return a.number.size();
+    }
+
+    static void accumulate(const big_number &a, big_number &out, bool negate) {
+        big_number::accumulate(out, a.number, negate ? big_number::change_sign(a.sign) : a.sign);
+    }
+
+    static bool references(const big_number &a, const big_number *p) {
+        return &a == p;
+    }
+
+    static const big_number &value(const big_number &a) {
+        return a;
+    }
+};
+
+template<typename E>
+struct expr_node_traits {
+    static const bool is_operand = true;
+    static const bool is_node = true;
+    typedef E stored;
+
+    static size_t size_hint(const E &e) {
+        return e.size_hint();
+    }
+
+    static void accumulate(const E &e, big_number &out, bool negate) {
+        e.accumulate_into(out, negate);
+    }
+
+    static bool references(const E &e, const big_number *p) {
+        return e.references(p);
+    }
+
+    static big_number value(const E &e) {
+        return big_number(e);
+    }
+};
+
+template<typename L, typename R, bool NEG>
+struct expr_traits<sum_expr<L, R, NEG>> : expr_node_traits<sum_expr<L, R, NEG>> {
+};
+
+template<typename L, typename R>
+struct expr_traits<product_expr<L, R>> : expr_node_traits<product_expr<L, R>> {
+};
+
+/**
+ * l + r or l - r when NEG is set
+ */
+template<typename L, typename R, bool NEG>
+class sum_expr {
+
+public:
+
+    sum_expr(const L &l, const R &r) : l(l), r(r) {}
+
+    /**
+     * @return upper bound of number of limbs of the result
+     */
+    size_t size_hint() const {
+        return std::max(expr_traits<L>::size_hint(l), expr_traits<R>::size_hint(r)) + 1;
+    }
+
+    /**
+     * adds value of expression (or its negation) to out in place
+     */
+    void accumulate_into(big_number &out, bool negate) const {
+        expr_traits<L>::accumulate(l, out, negate);
+        expr_traits<R>::accumulate(r, out, negate != NEG);
+    }
+
+    /**
+     * check if p is one of operands
+     */
+    bool references(const big_number *p) const {
+        return expr_traits<L>::references(l, p) || expr_traits<R>::references(r, p);
+    }
+
+private:
+    typename expr_traits<L>::stored l;
+    typename expr_traits<R>::stored r;
+};
+
+/**
+ * l * r, nested operands are evaluated first
+ */
+template<typename L, typename R>
+class product_expr {
+
+public:
+
+    product_expr(const L &l, const R &r) : l(l), r(r) {}
+
+    size_t size_hint() const {
+        return expr_traits<L>::size_hint(l) + expr_traits<R>::size_hint(r);
+    }
+
+    void accumulate_into(big_number &out, bool negate) const {
+        big_number::add_product(out, expr_traits<L>::value(l), expr_traits<R>::value(r), negate);
+    }
+
+    bool references(const big_number *p) const {
+        return expr_traits<L>::references(l, p) || expr_traits<R>::references(r, p);
+    }
+
+private:
+    typename expr_traits<L>::stored l;
+    typename expr_traits<R>::stored r;
+};
+
+template<typename E, typename>
+big_number::big_number(const E &e) : number(1, 0), sign(PLUS) {
+    number.reserve(expr_traits<E>::size_hint(e));
+    e.accumulate_into(*this, false);
+}
+
+template<typename E, typename>
+big_number &big_number::operator=(const E &e) {
+    return *this = big_number(e);
+}
+
+template<typename E, typename>
+big_number &big_number::operator+=(const E &e) {
+    if (e.references(this)) {
+        return *this += big_number(e);
+    }
+    e.accumulate_into(*this, false);
+    return *this;
+}
+
+template<typename E, typename>
+big_number &big_number::operator-=(const E &e) {
+    if (e.references(this)) {
+        return *this -= big_number(e);
+    }
+    e.accumulate_into(*this, true);
+    return *this;
+}
+
+template<typename L, typename R>
+typename std::enable_if<expr_traits<L>::is_operand && expr_traits<R>::is_operand, sum_expr<L, R, false>>::type
+operator+(const L &a, const R &b) {
+    return sum_expr<L, R, false>(a, b);
+}
+
+template<typename L, typename R>
+typename std::enable_if<expr_traits<L>::is_operand && expr_traits<R>::is_operand, sum_expr<L, R, true>>::type
+operator-(const L &a, const R &b) {
+    return sum_expr<L, R, true>(a, b);
+}
+
+template<typename L, typename R>
+typename std::enable_if<expr_traits<L>::is_operand && expr_traits<R>::is_operand, product_expr<L, R>>::type
+operator*(const L &a, const R &b) {
+    return product_expr<L, R>(a, b);
+}
+
+
+#endif //ALGORITHMS_BIG_NUMBER_EXPR_H
@@ -0,0 +1,149 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_BUMP_ARENA_H
+#define ALGORITHMS_BUMP_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * bump allocator for short lived buffers, allocation moves offset in current block
+ * and single allocations are never freed, whole arena is released at once
+ *
+ * while scope is active, big_number takes limbs of intermediate results of its operations
+ * on that thread from the arena, values it hands out (results of operators, copies
+ * and moves of numbers) live on the heap, so they stay valid after the arena is gone
+ */
+class bump_arena {
+
+public:
+
+    /**
+     * @param block_size size (in bytes) of blocks requested from heap
+     */
+    explicit bump_arena(size_t block_size = 1 << 20);
+
+    ~bump_arena();
+
+    bump_arena(const bump_arena &) = delete;
+
+    bump_arena &operator=(const bump_arena &) = delete;
+
+    /**
+     * @return pointer to bytes aligned to align (power of two)
+     * time complexity: amortized O(1)
+     */
+    void *allocate(size_t bytes, size_t align);
+
+    /**
+     * drops all allocations, memory is kept (merged into one block) for reuse
+     */
+    void reset();
+
+    /**
+     * @return bytes handed out since last reset
+     */
+    size_t used() const;
+
+    /**
+     * @return arena bound to calling thread or nullptr
+     */
+    static bump_arena *current();
+
+    /**
+     * binds arena to calling thread for its lifetime
+     */
+    class scope {
+    public:
+        explicit scope(bump_arena &arena) : previous(_bound()) {
+            _bound() = &arena;
+        }
+
+        ~scope() {
+            _bound() = previous;
+        }
+
+    private:
+        bump_arena *previous;
+    };
+
+private:
+
+    struct block {
+        char *data;
+        size_t size;
+    };
+
+    std::vector<block> blocks;
+    size_t block_size;
+    size_t offset;
+    size_t total;
+
+    static bump_arena *&_bound();
+    void _add_block(size_t size);
+};
+
+inline bump_arena::bump_arena(size_t block_size) : block_size(std::max<size_t>(block_size, 64)), offset(0),
+                                                   total(0) {
+
+}
+
+inline bump_arena::~bump_arena() {
+    for (auto &b: blocks) {
+        delete[] b.data;
+    }
+}
+
+inline void *bump_arena::allocate(size_t bytes, size_t align) {
+    if (!blocks.empty()) {
+        uintptr_t base = (uintptr_t) blocks.back().data;
+        size_t start = (size_t) (((base + offset + align - 1) & ~(uintptr_t) (align - 1)) - base);
+        if (start + bytes <= blocks.back().size) {
+            offset = start + bytes;
+            total += bytes;
+            return blocks.back().data + start;
+        }
+    }
+    _add_block(std::max(block_size, bytes + align));
+    return allocate(bytes, align);
+}
+
+inline void bump_arena::reset() {
+    if (blocks.size() > 1) {
+        size_t size = 0;
+        for (auto &b: blocks) {
+            size += b.size;
+            delete[] b.data;
+        }
+        blocks.clear();
+        _add_block(size);
+    }
+    offset = 0;
+    total = 0;
+}
+
+inline size_t bump_arena::used() const {
+    return total;
+}
+
+inline bump_arena *bump_arena::current() {
+    return _bound();
+}
+
+inline bump_arena *&bump_arena::_bound() {
+    static thread_local bump_arena *bound = nullptr;
+    return bound;
+}
+
+inline void bump_arena::_add_block(size_t size) {
+    blocks.push_back({new char[size], size});
+    offset = 0;
+}
+
+
+#endif //ALGORITHMS_BUMP_ARENA_H
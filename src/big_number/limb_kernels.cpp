@@ -0,0 +1,223 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#include "limb_kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIMB_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+static uint32_t add_tail(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n, uint32_t carry) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t s = a[i] + b[i] + carry;
+        carry = s >= limb_kernels::BASE;
+        r[i] = carry ? s - limb_kernels::BASE : s;
+    }
+    return carry;
+}
+
+static uint32_t add_scalar(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    return add_tail(r, a, b, n, 0);
+}
+
+static uint32_t sub_tail(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n, uint32_t borrow) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t d = b[i] + borrow;
+        borrow = a[i] < d;
+        r[i] = borrow ? a[i] + limb_kernels::BASE - d : a[i] - d;
+    }
+    return borrow;
+}
+
+static uint32_t sub_scalar(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    return sub_tail(r, a, b, n, 0);
+}
+
+static void addmul_scalar(uint64_t *acc, const uint32_t *a, size_t n, uint32_t q) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] += (uint64_t) a[i] * q;
+    }
+}
+
+#ifdef LIMB_KERNELS_X86
+
+/*
+ * carries between lanes are resolved with one integer addition on lane masks:
+ * lane generates carry when its sum is at least BASE (g) and propagates incoming carry
+ * when its sum is BASE - 1 (p), adding (g | p) + g + carry_in gives s with
+ * incoming carry of lane i equal to bit i of s ^ p and carry out of the vector in next bit
+ */
+
+__attribute__((target("avx2")))
+static __m256i lanes_from_mask(unsigned mask) {
+    const __m256i shifts = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int) mask), shifts), _mm256_set1_epi32(1));
+}
+
+__attribute__((target("avx2")))
+static unsigned mask_of(__m256i x) {
+    return (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(x));
+}
+
+__attribute__((target("avx2")))
+static uint32_t add_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    const __m256i base = _mm256_set1_epi32((int) limb_kernels::BASE);
+    const __m256i top = _mm256_set1_epi32((int) limb_kernels::BASE - 1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *) (a + i)),
+                                     _mm256_loadu_si256((const __m256i *) (b + i)));
+        unsigned g = mask_of(_mm256_cmpgt_epi32(s, top));
+        unsigned p = mask_of(_mm256_cmpeq_epi32(s, top));
+        unsigned c = (g | p) + g + carry;
+        carry = c >> 8;
+        s = _mm256_add_epi32(s, lanes_from_mask((c ^ p) & 0xFF));
+        s = _mm256_min_epu32(s, _mm256_sub_epi32(s, base));
+        _mm256_storeu_si256((__m256i *) (r + i), s);
+    }
+    return add_tail(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx2")))
+static uint32_t sub_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    const __m256i base = _mm256_set1_epi32((int) limb_kernels::BASE);
+    const __m256i zero = _mm256_setzero_si256();
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + i));
+        __m256i lt = _mm256_cmpgt_epi32(vb, va);
+        __m256i d = _mm256_add_epi32(_mm256_sub_epi32(va, vb), _mm256_and_si256(lt, base));
+        unsigned g = mask_of(lt);
+        unsigned p = mask_of(_mm256_cmpeq_epi32(d, zero));
+        unsigned c = (g | p) + g + borrow;
+        borrow = c >> 8;
+        d = _mm256_sub_epi32(d, lanes_from_mask((c ^ p) & 0xFF));
+        d = _mm256_min_epu32(d, _mm256_add_epi32(d, base));
+        _mm256_storeu_si256((__m256i *) (r + i), d);
+    }
+    return sub_tail(r + i, a + i, b + i, n - i, borrow);
+}
+
+__attribute__((target("avx2")))
+static void addmul_avx2(uint64_t *acc, const uint32_t *a, size_t n, uint32_t q) {
+    const __m256i vq = _mm256_set1_epi64x(q);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) (a + i)));
+        __m256i vacc = _mm256_loadu_si256((const __m256i *) (acc + i));
+        _mm256_storeu_si256((__m256i *) (acc + i), _mm256_add_epi64(vacc, _mm256_mul_epu32(va, vq)));
+    }
+    addmul_scalar(acc + i, a + i, n - i, q);
+}
+
+// unmasked forms of min, mul and widening conversion start from an undefined vector
+// in GCC headers, which -Wmaybe-uninitialized reports, zero-masked forms with full mask
+// compile to the same instructions
+static const __mmask16 ALL16 = 0xFFFF;
+static const __mmask8 ALL8 = 0xFF;
+
+__attribute__((target("avx512f")))
+static uint32_t add_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    const __m512i base = _mm512_set1_epi32((int) limb_kernels::BASE);
+    const __m512i top = _mm512_set1_epi32((int) limb_kernels::BASE - 1);
+    const __m512i one = _mm512_set1_epi32(1);
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i s = _mm512_add_epi32(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        uint32_t g = _mm512_cmpgt_epu32_mask(s, top);
+        uint32_t p = _mm512_cmpeq_epu32_mask(s, top);
+        uint32_t c = (g | p) + g + carry;
+        carry = c >> 16;
+        s = _mm512_mask_add_epi32(s, (__mmask16) (c ^ p), s, one);
+        s = _mm512_maskz_min_epu32(ALL16, s, _mm512_sub_epi32(s, base));
+        _mm512_storeu_si512(r + i, s);
+    }
+    return add_tail(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx512f")))
+static uint32_t sub_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    const __m512i base = _mm512_set1_epi32((int) limb_kernels::BASE);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+        __mmask16 lt = _mm512_cmplt_epu32_mask(va, vb);
+        __m512i d = _mm512_mask_add_epi32(_mm512_sub_epi32(va, vb), lt, _mm512_sub_epi32(va, vb), base);
+        uint32_t g = lt;
+        uint32_t p = _mm512_cmpeq_epu32_mask(d, zero);
+        uint32_t c = (g | p) + g + borrow;
+        borrow = c >> 16;
+        d = _mm512_mask_sub_epi32(d, (__mmask16) (c ^ p), d, one);
+        d = _mm512_maskz_min_epu32(ALL16, d, _mm512_add_epi32(d, base));
+        _mm512_storeu_si512(r + i, d);
+    }
+    return sub_tail(r + i, a + i, b + i, n - i, borrow);
+}
+
+__attribute__((target("avx512f")))
+static void addmul_avx512(uint64_t *acc, const uint32_t *a, size_t n, uint32_t q) {
+    const __m512i vq = _mm512_set1_epi64(q);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i va = _mm512_maskz_cvtepu32_epi64(ALL8, _mm256_loadu_si256((const __m256i *) (a + i)));
+        __m512i vacc = _mm512_loadu_si512(acc + i);
+        _mm512_storeu_si512(acc + i, _mm512_add_epi64(vacc, _mm512_maskz_mul_epu32(ALL8, va, vq)));
+    }
+    addmul_avx2(acc + i, a + i, n - i, q);
+}
+
+#endif
+
+limb_kernels::table limb_kernels::kernels = {SCALAR, add_scalar, sub_scalar, addmul_scalar};
+
+// upgrades statically initialized scalar kernels once the program starts
+static struct limb_kernels_init {
+    limb_kernels_init() {
+        limb_kernels::select(limb_kernels::best());
+    }
+} init;
+
+limb_kernels::ISA limb_kernels::best() {
+#ifdef LIMB_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+#endif
+    return SCALAR;
+}
+
+limb_kernels::ISA limb_kernels::current() {
+    return kernels.isa;
+}
+
+void limb_kernels::select(limb_kernels::ISA isa) {
+    ISA b = best();
+    kernels = _make(isa < b ? isa : b);
+}
+
+limb_kernels::table limb_kernels::_make(limb_kernels::ISA isa) {
+#ifdef LIMB_KERNELS_X86
+    if (isa == AVX512) {
+        return {AVX512, add_avx512, sub_avx512, addmul_avx512};
+    }
+    if (isa == AVX2) {
+        return {AVX2, add_avx2, sub_avx2, addmul_avx2};
+    }
+#endif
+    return {SCALAR, add_scalar, sub_scalar, addmul_scalar};
+}
@@ -0,0 +1,89 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_LIMB_KERNELS_H
+#define ALGORITHMS_LIMB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * hot loops over base 10^9 limbs, implemented with AVX-512, AVX2 and portable scalar code,
+ * the fastest version supported by CPU is chosen at runtime
+ */
+class limb_kernels {
+
+public:
+
+    enum ISA {
+        SCALAR, AVX2, AVX512
+    };
+
+    static const uint32_t BASE = 1000000000;
+
+    /**
+     * r = a + b on n limbs, r may be the same as a or b
+     * @return carry out of the last limb
+     */
+    static uint32_t add(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+    /**
+     * r = a - b on n limbs, r may be the same as a or b
+     * @return borrow out of the last limb
+     */
+    static uint32_t sub(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+
+    /**
+     * acc[i] += a[i] * q without carry propagation,
+     * every entry can take 18 such updates on top of a normalized limb
+     */
+    static void addmul(uint64_t *acc, const uint32_t *a, size_t n, uint32_t q);
+
+    /**
+     * @return best instruction set supported by this CPU
+     */
+    static ISA best();
+
+    /**
+     * @return instruction set of kernels in use
+     */
+    static ISA current();
+
+    /**
+     * switches kernels to given instruction set, or to the best supported one below it,
+     * meant for benchmarks and tests, not thread safe
+     */
+    static void select(ISA isa);
+
+private:
+
+    typedef uint32_t (*ADD_SUB)(uint32_t *, const uint32_t *, const uint32_t *, size_t);
+    typedef void (*ADDMUL)(uint64_t *, const uint32_t *, size_t, uint32_t);
+
+    struct table {
+        ISA isa;
+        ADD_SUB add, sub;
+        ADDMUL addmul;
+    };
+
+    static table kernels;
+
+    static table _make(ISA isa);
+};
+
+inline uint32_t limb_kernels::add(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    return kernels.add(r, a, b, n);
+}
+
+inline uint32_t limb_kernels::sub(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+    return kernels.sub(r, a, b, n);
+}
+
+inline void limb_kernels::addmul(uint64_t *acc, const uint32_t *a, size_t n, uint32_t q) {
+    kernels.addmul(acc, a, n, q);
+}
+
+
+#endif //ALGORITHMS_LIMB_KERNELS_H
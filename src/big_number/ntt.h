@@ -0,0 +1,147 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_NTT_H
+#define ALGORITHMS_NTT_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * number theoretic transform modulo prime P = c * 2^k + 1 with primitive root G
+ * used for exact convolution of limb vectors
+ */
+template<uint32_t P, uint32_t G>
+class ntt {
+
+public:
+
+    typedef std::vector<uint32_t> V;
+
+    static const uint32_t MOD = P;
+
+    /**
+     * @return a * b mod P
+     */
+    static uint32_t mul(uint32_t a, uint32_t b);
+
+    /**
+     * @return a ^ e mod P
+     * time complexity: O(log e)
+     */
+    static uint32_t power(uint32_t a, uint64_t e);
+
+    /**
+     * transforms a in place, size of a has to be a power of two dividing P - 1
+     * time complexity: O(n log n)
+     */
+    static void transform(V &a, bool inverse);
+
+    /**
+     * @return cyclic convolution of limb containers a and b of length n (power of two) modulo P,
+     * if a and b are the same vector it is transformed only once
+     * time complexity: O(n log n)
+     */
+    template<typename C>
+    static V convolve(const C &a, const C &b, size_t n);
+
+private:
+
+    template<typename C>
+    static V _reduce(const C &a, size_t n);
+};
+
+template<uint32_t P, uint32_t G>
+uint32_t ntt<P, G>::mul(uint32_t a, uint32_t b) {
+    return (uint32_t) ((uint64_t) a * b % P);
+}
+
+template<uint32_t P, uint32_t G>
+uint32_t ntt<P, G>::power(uint32_t a, uint64_t e) {
+    uint32_t r = 1;
+    while (e > 0) {
+        if (e & 1) {
+            r = mul(r, a);
+        }
+        a = mul(a, a);
+        e >>= 1;
+    }
+    return r;
+}
+
+template<uint32_t P, uint32_t G>
+void ntt<P, G>::transform(V &a, bool inverse) {
+    size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+    V w(n / 2 + 1);
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        uint32_t wl = power(G, (P - 1) / len);
+        if (inverse) {
+            wl = power(wl, P - 2);
+        }
+        w[0] = 1;
+        for (size_t j = 1; j < half; j++) {
+            w[j] = mul(w[j - 1], wl);
+        }
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; j++) {
+                uint32_t u = a[i + j];
+                uint32_t v = mul(a[i + j + half], w[j]);
+                a[i + j] = u + v >= P ? u + v - P : u + v;
+                a[i + j + half] = u >= v ? u - v : u + P - v;
+            }
+        }
+    }
+    if (inverse) {
+        uint32_t inv = power((uint32_t) (n % P), P - 2);
+        for (auto &x: a) {
+            x = mul(x, inv);
+        }
+    }
+}
+
+template<uint32_t P, uint32_t G>
+template<typename C>
+typename ntt<P, G>::V ntt<P, G>::convolve(const C &a, const C &b, size_t n) {
+    V fa = _reduce(a, n);
+    transform(fa, false);
+    if (&a == &b) {
+        for (auto &x: fa) {
+            x = mul(x, x);
+        }
+    } else {
+        V fb = _reduce(b, n);
+        transform(fb, false);
+        for (size_t i = 0; i < n; i++) {
+            fa[i] = mul(fa[i], fb[i]);
+        }
+    }
+    transform(fa, true);
+    return fa;
+}
+
+template<uint32_t P, uint32_t G>
+template<typename C>
+typename ntt<P, G>::V ntt<P, G>::_reduce(const C &a, size_t n) {
+    V r(n, 0);
+    for (size_t i = 0; i < a.size() && i < n; i++) {
+        r[i] = a[i] % P;
+    }
+    return r;
+}
+
+
+#endif //ALGORITHMS_NTT_H
@@ -0,0 +1,307 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_SMALL_VECTOR_H
+#define ALGORITHMS_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include "bump_arena.h"
+
+/**
+ * contiguous array of trivially copyable items which keeps up to N items inline
+ * and moves them to heap only when it outgrows the inline buffer,
+ * heap buffer is allocated with new[], or taken from arena given to constructor,
+ * buffer never passes to vector with other arena (or none), items are copied then,
+ * so vectors built by any other constructor never refer to an arena
+ */
+template<typename T, size_t N>
+class small_vector {
+
+    static_assert(std::is_trivially_copyable<T>::value, "small_vector requires trivially copyable items");
+
+public:
+
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    /**
+     * creates empty vector using inline buffer
+     */
+    small_vector();
+
+    /**
+     * creates empty vector which takes heap buffers from given arena (new[] for nullptr),
+     * it must not be used after the arena is reset or destroyed
+     */
+    explicit small_vector(bump_arena *arena);
+
+    /**
+     * creates vector of n copies of value
+     * time complexity: O(n)
+     */
+    explicit small_vector(size_t n, const T &value = T());
+
+    /**
+     * creates vector from items in range [first, last)
+     * time complexity: O(n)
+     */
+    small_vector(const T *first, const T *last);
+
+    small_vector(std::initializer_list<T> items);
+
+    small_vector(const small_vector &v);
+
+    /**
+     * steals heap buffer of v, inline items and buffer of arena are copied
+     * time complexity: O(1) unless v uses arena
+     */
+    small_vector(small_vector &&v) noexcept;
+
+    ~small_vector();
+
+    small_vector &operator=(const small_vector &v);
+
+    /**
+     * steals heap buffer of v if both take buffers from the same arena, otherwise copies items
+     */
+    small_vector &operator=(small_vector &&v);
+
+    size_t size() const { return n; }
+
+    size_t capacity() const { return cap; }
+
+    bool empty() const { return n == 0; }
+
+    /**
+     * check if items are stored in inline buffer
+     */
+    bool is_inline() const { return ptr == buf; }
+
+    T *data() { return ptr; }
+
+    const T *data() const { return ptr; }
+
+    iterator begin() { return ptr; }
+
+    iterator end() { return ptr + n; }
+
+    const_iterator begin() const { return ptr; }
+
+    const_iterator end() const { return ptr + n; }
+
+    T &operator[](size_t i) { return ptr[i]; }
+
+    const T &operator[](size_t i) const { return ptr[i]; }
+
+    T &front() { return ptr[0]; }
+
+    const T &front() const { return ptr[0]; }
+
+    T &back() { return ptr[n - 1]; }
+
+    const T &back() const { return ptr[n - 1]; }
+
+    /**
+     * time complexity: amortized O(1)
+     */
+    void push_back(const T &value);
+
+    void pop_back() { n--; }
+
+    void clear() { n = 0; }
+
+    /**
+     * makes sure that at least c items fit without reallocation
+     */
+    void reserve(size_t c);
+
+    void resize(size_t size, const T &value = T());
+
+    void assign(size_t size, const T &value);
+
+    /**
+     * inserts items from range [first, last) before pos, range must not point into this vector
+     * time complexity: O(n)
+     */
+    iterator insert(const_iterator pos, const T *first, const T *last);
+
+    /**
+     * exchanges buffers if both take them from the same arena, otherwise copies items
+     */
+    void swap(small_vector &v);
+
+private:
+
+    T *ptr;
+    size_t n;
+    size_t cap;
+    T buf[N];
+    // heap buffer is taken from this arena, or allocated with new[] when it is nullptr
+    bump_arena *arena;
+
+    void _grow(size_t c);
+    void _release();
+};
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector() : ptr(buf), n(0), cap(N), arena(nullptr) {
+
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(bump_arena *arena) : small_vector() {
+    this->arena = arena;
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(size_t n, const T &value) : small_vector() {
+    assign(n, value);
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(const T *first, const T *last) : small_vector() {
+    insert(end(), first, last);
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(std::initializer_list<T> items) : small_vector() {
+    insert(end(), items.begin(), items.end());
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(const small_vector &v) : small_vector() {
+    insert(end(), v.begin(), v.end());
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::small_vector(small_vector &&v) noexcept : small_vector() {
+    swap(v);
+}
+
+template<typename T, size_t N>
+small_vector<T, N>::~small_vector() {
+    _release();
+}
+
+template<typename T, size_t N>
+small_vector<T, N> &small_vector<T, N>::operator=(const small_vector &v) {
+    if (this != &v) {
+        n = 0;
+        insert(end(), v.begin(), v.end());
+    }
+    return *this;
+}
+
+template<typename T, size_t N>
+small_vector<T, N> &small_vector<T, N>::operator=(small_vector &&v) {
+    if (this != &v) {
+        n = 0;
+        swap(v);
+    }
+    return *this;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::push_back(const T &value) {
+    if (n == cap) {
+        _grow(2 * cap);
+    }
+    ptr[n++] = value;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::reserve(size_t c) {
+    if (c > cap) {
+        _grow(c);
+    }
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::resize(size_t size, const T &value) {
+    if (size > cap) {
+        _grow(std::max(size, 2 * cap));
+    }
+    if (size > n) {
+        std::fill(ptr + n, ptr + size, value);
+    }
+    n = size;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::assign(size_t size, const T &value) {
+    n = 0;
+    resize(size, value);
+}
+
+template<typename T, size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(const_iterator pos, const T *first, const T *last) {
+    size_t i = pos - ptr, k = last - first;
+    if (n + k > cap) {
+        _grow(std::max(n + k, 2 * cap));
+    }
+    if (k > 0) {
+        std::memmove(ptr + i + k, ptr + i, (n - i) * sizeof(T));
+        std::memcpy(ptr + i, first, k * sizeof(T));
+    }
+    n += k;
+    return ptr + i;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::swap(small_vector &v) {
+    if (arena != v.arena) {
+        // buffer of arena could outlive it in the other vector
+        small_vector temp;
+        temp.arena = nullptr;
+        temp.insert(temp.end(), begin(), end());
+        n = 0;
+        insert(end(), v.begin(), v.end());
+        v.n = 0;
+        v.insert(v.end(), temp.begin(), temp.end());
+        return;
+    }
+    if (!is_inline() && !v.is_inline()) {
+        std::swap(ptr, v.ptr);
+        std::swap(cap, v.cap);
+    } else if (is_inline() && v.is_inline()) {
+        T temp[N];
+        std::memcpy(temp, buf, n * sizeof(T));
+        std::memcpy(buf, v.buf, v.n * sizeof(T));
+        std::memcpy(v.buf, temp, n * sizeof(T));
+    } else {
+        small_vector &h = is_inline() ? v : *this;
+        small_vector &s = is_inline() ? *this : v;
+        std::memcpy(h.buf, s.buf, s.n * sizeof(T));
+        s.ptr = h.ptr;
+        s.cap = h.cap;
+        h.ptr = h.buf;
+        h.cap = N;
+    }
+    std::swap(n, v.n);
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::_grow(size_t c) {
+    T *p = arena ? (T *) arena->allocate(c * sizeof(T), alignof(T)) : new T[c];
+    std::memcpy(p, ptr, n * sizeof(T));
+    _release();
+    ptr = p;
+    cap = c;
+}
+
+template<typename T, size_t N>
+void small_vector<T, N>::_release() {
+    if (!is_inline() && arena == nullptr) {
+        delete[] ptr;
+    }
+}
+
+
+#endif //ALGORITHMS_SMALL_VECTOR_H
@@ -0,0 +1,112 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#include "task_pool.h"
+
+struct task_pool::batch {
+    const TASKS *tasks;
+    size_t next;
+    size_t done;
+    std::exception_ptr error;
+};
+
+task_pool::task_pool(unsigned workers) : stop(false) {
+    for (unsigned i = 1; i < workers; i++) {
+        threads.emplace_back(&task_pool::_worker, this);
+    }
+}
+
+task_pool::~task_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stop = true;
+    }
+    work.notify_all();
+    for (auto &t: threads) {
+        t.join();
+    }
+}
+
+unsigned task_pool::workers() const {
+    return (unsigned) threads.size() + 1;
+}
+
+void task_pool::run(const TASKS &tasks) {
+    if (threads.empty() || tasks.size() < 2) {
+        for (auto &task: tasks) {
+            task();
+        }
+        return;
+    }
+    batch b{&tasks, 0, 0, nullptr};
+    {
+        std::lock_guard<std::mutex> lock(m);
+        pending.push_back(&b);
+    }
+    work.notify_all();
+    size_t i;
+    while (_claim(&b, i)) {
+        _execute(&b, i);
+    }
+    std::unique_lock<std::mutex> lock(m);
+    finished.wait(lock, [&b] { return b.done == b.tasks->size(); });
+    if (b.error) {
+        std::rethrow_exception(b.error);
+    }
+}
+
+void task_pool::_worker() {
+    while (true) {
+        batch *b;
+        size_t i;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            work.wait(lock, [this] { return stop || !pending.empty(); });
+            if (stop) {
+                return;
+            }
+            b = pending.front();
+            i = b->next++;
+            if (b->next == b->tasks->size()) {
+                pending.pop_front();
+            }
+        }
+        _execute(b, i);
+    }
+}
+
+bool task_pool::_claim(batch *b, size_t &i) {
+    std::lock_guard<std::mutex> lock(m);
+    if (b->next == b->tasks->size()) {
+        return false;
+    }
+    i = b->next++;
+    if (b->next == b->tasks->size()) {
+        for (auto it = pending.begin(); it != pending.end(); it++) {
+            if (*it == b) {
+                pending.erase(it);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+void task_pool::_execute(batch *b, size_t i) {
+    std::exception_ptr error;
+    try {
+        (*b->tasks)[i]();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (error && !b->error) {
+            b->error = error;
+        }
+        b->done++;
+    }
+    finished.notify_all();
+}
@@ -0,0 +1,67 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_TASK_POOL_H
+#define ALGORITHMS_TASK_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * fixed set of worker threads for fork-join parallelism,
+ * thread which runs a batch of tasks executes unclaimed tasks itself,
+ * so nested batches never wait for a free worker
+ */
+class task_pool {
+
+public:
+
+    typedef std::vector<std::function<void()>> TASKS;
+
+    /**
+     * starts workers - 1 threads, calling thread is the last worker
+     */
+    explicit task_pool(unsigned workers);
+
+    ~task_pool();
+
+    task_pool(const task_pool &) = delete;
+
+    task_pool &operator=(const task_pool &) = delete;
+
+    /**
+     * @return number of threads (including calling one) which can run tasks
+     */
+    unsigned workers() const;
+
+    /**
+     * runs all tasks and returns when all of them are finished,
+     * first exception thrown by a task is rethrown
+     */
+    void run(const TASKS &tasks);
+
+private:
+
+    struct batch;
+
+    std::vector<std::thread> threads;
+    std::deque<batch *> pending;
+    std::mutex m;
+    std::condition_variable work;
+    std::condition_variable finished;
+    bool stop;
+
+    void _worker();
+    bool _claim(batch *b, size_t &i);
+    void _execute(batch *b, size_t i);
+};
+
+
+#endif //ALGORITHMS_TASK_POOL_H
@@ -86,8 +86,7 @@ private:
 
     /**
      * finds distances between given node and all other nodes
-     * uses Dijkstra's algorithm in time O(E*logV), we probably use heap not fibonacci heap
-     * with fibonacci heap the complexity is O(E + V*logV)
+     * uses Dijkstra's algorithm with pairing heap
      * does not work with negative weights
      * @param src starting node
      * @param g graph
@@ -96,6 +95,15 @@ private:
     template<typename V>
     friend VI dijkstra(int src, const abstract_graph<V, weighted_edge> &g);
 
+    /**
+     * dijkstra with given heap Q of 64-bit integer keys (e.g. fibonacci_heap<long long>),
+     * calls to heap are resolved at compile time
+     * time complexity: O(E*logV) with binary heap, O(E + V*logV) with fibonacci heap
+     * (key of node is distance * 2^32 + node, so radix heap works as well)
+     */
+    template<typename Q, typename V>
+    friend VI dijkstra(int src, const abstract_graph<V, weighted_edge> &g);
+
     /**
      * finds distances between all pair of nodes
      * uses Floyd-Warshall's algorithm in time O(V^3)
@@ -254,19 +262,44 @@ void abstract_graph<N, E>::_dfs_rec(int src,
 
 template<typename N>
 VI dijkstra(int src, const abstract_graph<N, weighted_edge> &g) {
+    return dijkstra<PQK>(src, g);
+}
+
+template<typename Q, typename N>
+VI dijkstra(int src, const abstract_graph<N, weighted_edge> &g) {
+    typedef typename Q::KEY K;
+    const K SHIFT = (K) 1 << 32;
     VI result(g.size(), 1e9);
+    // nodes reached by edges of weight 0, they are done without going through heap,
+    // so keys put to heap never go below last min
+    VI same;
+    Q q;
     result[src] = 0;
-    PQN q;
-    REP(i, g.size()) {
-        q.push(MP(result[i], i));
-    }
+    q.push((K) src);
     while (!q.empty()) {
-        int u = q.top().second;
-        q.pop();;
-        for (auto e: g.nodes[u]) {
-            if (result[u] + e.value < result[e.dst]) {
-                q.push(MP(result[u] + e.value, e.dst));
-                result[e.dst] = result[u] + e.value;
+        same.push_back((int) (q.top() % SHIFT));
+        q.pop();
+        while (!same.empty()) {
+            int u = same.back();
+            same.pop_back();
+            for (auto e: g.nodes[u]) {
+                int v = e.dst, d = result[u] + e.value;
+                if (d >= result[v]) {
+                    continue;
+                }
+                bool queued = result[v] != (int) 1e9;
+                K key = (K) result[v] * SHIFT + v;
+                if (d == result[u]) {
+                    if (queued) {
+                        q.remove(key);
+                    }
+                    same.push_back(v);
+                } else if (queued) {
+                    q.decrease(key, (K) d * SHIFT + v);
+                } else {
+                    q.push((K) d * SHIFT + v);
+                }
+                result[v] = d;
             }
         }
     }
@@ -18,6 +18,7 @@
 #include <bitset>
 #include "structs.h"
 #include "../disjoint_sets/disjoint_sets.h"
+#include "../heap/pairing_heap.h"
 
 #define MP(a, b) std::make_pair((a), (b))
 #define ALL(a) (a).begin(), (a).end()
@@ -35,5 +36,7 @@ typedef std::vector<std::pair<int, std::pair<int, int>>> VIE;
 typedef std::deque<int> QI;
 typedef std::priority_queue<std::pair<int, int>> PQN;
 typedef std::priority_queue<std::pair<int, std::pair<int, int>>> PQE;
+// heap used by Dijkstra's and Prim's algorithms unless other one is given
+typedef pairing_heap<long long> PQK;
 
 #endif //ALGORITHMS_HELPERS_H
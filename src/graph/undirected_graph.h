@@ -45,14 +45,23 @@ private:
 
     /**
      * Finds minimum spanning tree of the graph.
-     * Uses Prim's algorithm in time O(E*logV).
-     * Unless using fibonacci heap then time complexity is O(E + V*logV).
+     * Uses Prim's algorithm with pairing heap.
      * @param g graph
      * @return cost of minimum spanning tree
      */
     template<typename V>
     friend int prim(const graph<V, weighted_edge> &g);
 
+    /**
+     * Prim's algorithm with given heap Q of 64-bit integer keys (e.g. fibonacci_heap<long long>),
+     * calls to heap are resolved at compile time.
+     * Time complexity is O(E*logV) with binary heap, O(E + V*logV) with fibonacci heap.
+     * @param g graph
+     * @return cost of minimum spanning tree of component of node 0
+     */
+    template<typename Q, typename V>
+    friend int prim(const graph<V, weighted_edge> &g);
+
 };
 
 
@@ -187,25 +196,41 @@ int kruskal(const graph<N, weighted_edge> &g) {
 
 template<typename N>
 int prim(const graph<N, weighted_edge> &g) {
-    VIN result;
+    return prim<PQK>(g);
+}
+
+template<typename Q, typename N>
+int prim(const graph<N, weighted_edge> &g) {
+    // key of node is weight of its cheapest edge to tree * 2^32 + node
+    typedef typename Q::KEY K;
+    const K SHIFT = (K) 1 << 32;
     int cost = 0;
-    bool visited[g.size()]{false};
-    PQE q;
-    visited[0] = true;
-    for (auto e: g.nodes[0]) {
-        q.push(MP(e.value, MP(0, e.dst)));
+    VI best(g.size(), 0);
+    std::vector<bool> visited(g.size(), false), queued(g.size(), false);
+    Q q;
+    if (g.size() == 0) {
+        return cost;
     }
-    while (result.size() + 1 != g.size()) {
-        auto ed = q.top();
+    q.push(0);
+    queued[0] = true;
+    while (!q.empty()) {
+        int u = (int) (q.top() & (SHIFT - 1));
         q.pop();
-        int dst = ed.second.second;
-        if (!visited[dst]) {
-            visited[dst] = true;
-            cost += ed.first;
-            result.push_back(ed.second);
-            for (auto e: g.nodes[dst]) {
-                q.push(MP(e.value, MP(dst, e.dst)));
+        visited[u] = true;
+        cost += best[u];
+        for (auto e: g.nodes[u]) {
+            int v = e.dst;
+            if (visited[v] || (queued[v] && e.value >= best[v])) {
+                continue;
+            }
+            K key = (K) e.value * SHIFT + v;
+            if (queued[v]) {
+                q.decrease((K) best[v] * SHIFT + v, key);
+            } else {
+                q.push(key);
+                queued[v] = true;
             }
+            best[v] = e.value;
         }
     }
     return cost;
@@ -7,115 +7,166 @@
 #define ALGORITHMS_BINARY_HEAP_H
 
 #include "priority_queue.h"
+#include "heap_stats.h"
+#include <algorithm>
+#include <functional>
 #include <unordered_map>
 
-template<typename T>
-class binary_heap : public priority_queue<T> {
+/**
+ * comparator C(a, b) is true when a leaves heap before b,
+ * std::less gives min heap and std::greater max heap,
+ * decrease moves key towards top in that order
+ */
+template<typename T, typename C = std::less<T>>
+class binary_heap : public heap_base<binary_heap<T, C>, T> {
 
 public:
 
+    using heap_base<binary_heap<T, C>, T>::meld;
+
     /**
      * creates empty heap
      */
-    binary_heap();
+    explicit binary_heap(const C &compare = C());
 
     /**
      * creates heap from given items
      * time complexity: O(n)
      */
-    binary_heap(std::initializer_list<T> items);
+    binary_heap(std::initializer_list<T> items, const C &compare = C());
 
     /**
      * check if heap is empty
      * time complexity: O(1)
      */
-    bool empty() const override;
+    bool empty() const;
 
     /**
      * @return number of items in heap
      * time complexity: O(1)
      */
-    size_t size() const override;
+    size_t size() const;
 
     /**
      * check if given key belongs to heap
      * time complexity: O(1)
      */
-    bool contains(const T &key) const override;
+    bool contains(const T &key) const;
 
     /**
      * @return min key
      * time complexity: O(1)
      */
-    T top() const override;
+    T top() const;
 
     /**
      * insert new key to heap
      * time complexity: O(log n)
      */
-    void push(const T &key) override;
+    void push(const T &key);
 
     /**
      * extract min key from heap
      * time complexity: O(log n)
      */
-    void pop() override;
+    void pop();
 
     /**
      * decrease value of given key
      * time complexity: O(log n)
      */
-    void decrease(const T &key, const T &new_key) override;
+    void decrease(const T &key, const T &new_key);
 
     /**
      * remove given key from heap
      * time complexity: O(log n)
      */
-    void remove(const T &key) override;
+    void remove(const T &key);
+
+    /**
+     * insert all given keys, small batch is sifted up, large one rebuilds heap
+     * time complexity: O(min(k log n, n + k)) for k keys
+     */
+    void push_bulk(const std::vector<T> &keys);
+
+    /**
+     * move all keys of other heap to this one, h is left empty
+     * time complexity: O(min(m log n, n + m)) for h of size m
+     */
+    void meld(binary_heap &h);
+
+    /**
+     * @return counters of operations since creation, zeros unless HEAP_STATS is defined
+     */
+    heap_stats stats() const;
 
 private:
     typedef std::vector<T> V;
     typedef std::unordered_map<T, int> MAP;
     V items;
     MAP node_map;
+    C compare;
+#ifdef HEAP_STATS
+    heap_stats counters;
+    size_t buckets = 0;
+    void _record_sift(size_t levels);
+    void _record_growth();
+#endif
+    bool _compare(const T &a, const T &b);
     void _heapify(int i);
     void _swap(int i, int j);
     void _push_top(int i);
+    void _fix_appended(size_t from);
 };
 
-template<typename T>
-binary_heap<T>::binary_heap() : items(), node_map() {
+template<typename T, typename C>
+binary_heap<T, C>::binary_heap(const C &compare) : items(), node_map(), compare(compare) {
 
 }
 
-template<typename T>
-binary_heap<T>::binary_heap(std::initializer_list<T> items) : items(items), node_map() {
+template<typename T, typename C>
+binary_heap<T, C>::binary_heap(std::initializer_list<T> items, const C &compare) : items(items), node_map(),
+                                                                                   compare(compare) {
     int i = 0;
     for (auto item: items) {
         node_map[item] = i++;
     }
+    HEAP_COUNT(_record_growth();)
     for (i = (items.size() - 2) / 2; i > -1; --i) {
         _heapify(i);
     }
 }
 
-template<typename T>
-void binary_heap<T>::_heapify(int i) {
-    int min = i, l = 2 * i + 1, r = 2 * i + 2;
-    if (l < items.size()) {
-        min = items[min] > items[l] ? l : min;
-    }
-    if (r < items.size()) {
-        min = items[min] > items[r] ? r : min;
-    }
-    if (min != i) {
+template<typename T, typename C>
+bool binary_heap<T, C>::_compare(const T &a, const T &b) {
+    HEAP_COUNT(counters.comparisons++;)
+    return compare(a, b);
+}
+
+template<typename T, typename C>
+void binary_heap<T, C>::_heapify(int i) {
+    HEAP_COUNT(size_t levels = 0;)
+    while (true) {
+        int min = i, l = 2 * i + 1, r = 2 * i + 2;
+        if ((size_t) l < items.size()) {
+            min = _compare(items[l], items[min]) ? l : min;
+        }
+        if ((size_t) r < items.size()) {
+            min = _compare(items[r], items[min]) ? r : min;
+        }
+        if (min == i) {
+            break;
+        }
         _swap(min, i);
-        _heapify(min);
+        i = min;
+        HEAP_COUNT(levels++;)
     }
+    HEAP_COUNT(_record_sift(levels);)
 }
 
-template<typename T>
-void binary_heap<T>::_swap(int i, int j) {
+template<typename T, typename C>
+void binary_heap<T, C>::_swap(int i, int j) {
+    HEAP_COUNT(counters.swaps++;)
     T temp = items[i];
     items[i] = items[j];
     items[j] = temp;
@@ -123,74 +174,161 @@ void binary_heap<T>::_swap(int i, int j) {
     node_map[items[i]] = i;
 }
 
-template<typename T>
-bool binary_heap<T>::empty() const {
+template<typename T, typename C>
+bool binary_heap<T, C>::empty() const {
     return items.empty();
 }
 
-template<typename T>
-size_t binary_heap<T>::size() const {
+template<typename T, typename C>
+size_t binary_heap<T, C>::size() const {
     return items.size();
 }
 
-template<typename T>
-bool binary_heap<T>::contains(const T &key) const {
+template<typename T, typename C>
+bool binary_heap<T, C>::contains(const T &key) const {
     auto ptr = node_map.find(key);
     return ptr != node_map.end();
 }
 
-template<typename T>
-T binary_heap<T>::top() const {
+template<typename T, typename C>
+T binary_heap<T, C>::top() const {
     return items.front();
 }
 
-template<typename T>
-void binary_heap<T>::push(const T &key) {
+template<typename T, typename C>
+void binary_heap<T, C>::push(const T &key) {
     items.push_back(key);
     node_map[key] = items.size() - 1;
+    HEAP_COUNT(_record_growth();)
     _push_top(items.size() - 1);
 }
 
-template<typename T>
-void binary_heap<T>::_push_top(int i) {
+template<typename T, typename C>
+void binary_heap<T, C>::_push_top(int i) {
+    HEAP_COUNT(size_t levels = 0;)
     while (i > 0) {
         int parent = (i - 1) / 2;
-        if (items[parent] > items[i]) {
+        if (_compare(items[i], items[parent])) {
             _swap(parent, i);
         } else {
             break;
         }
         i = parent;
+        HEAP_COUNT(levels++;)
     }
+    HEAP_COUNT(_record_sift(levels);)
 }
 
-template<typename T>
-void binary_heap<T>::pop() {
+template<typename T, typename C>
+void binary_heap<T, C>::pop() {
     _swap(0, items.size() - 1);
+    node_map.erase(items.back());
     items.pop_back();
     _heapify(0);
 }
 
-template<typename T>
-void binary_heap<T>::decrease(const T &key, const T &new_key) {
-    if (key < new_key) {
+template<typename T, typename C>
+void binary_heap<T, C>::decrease(const T &key, const T &new_key) {
+    if (compare(key, new_key)) {
         throw "cannot increase key";
     }
     int i = node_map[key];
     items[i] = new_key;
     node_map.erase(key);
     node_map[new_key] = i;
+    HEAP_COUNT(_record_growth();)
     _push_top(i);
 }
 
-template<typename T>
-void binary_heap<T>::remove(const T &key) {
+template<typename T, typename C>
+void binary_heap<T, C>::remove(const T &key) {
     int i = node_map[key];
     _swap(i, items.size() - 1);
     items.pop_back();
     node_map.erase(key);
-    _heapify(i);
+    if ((size_t) i < items.size()) {
+        // last item fills the hole and moves up or down from there
+        _heapify(i);
+        _push_top(i);
+    }
 }
 
+template<typename T, typename C>
+void binary_heap<T, C>::push_bulk(const std::vector<T> &keys) {
+    size_t from = items.size();
+    items.insert(items.end(), keys.begin(), keys.end());
+    _fix_appended(from);
+}
+
+template<typename T, typename C>
+void binary_heap<T, C>::meld(binary_heap &h) {
+    if (&h == this) return;
+    if (items.size() < h.items.size()) {
+        items.swap(h.items);
+        node_map.swap(h.node_map);
+        HEAP_COUNT(buckets = node_map.bucket_count();)
+    }
+    size_t from = items.size();
+    items.insert(items.end(), h.items.begin(), h.items.end());
+    h.items.clear();
+    h.node_map.clear();
+    _fix_appended(from);
+}
+
+/**
+ * restores heap after items from given index were appended,
+ * sifts them up one by one when it is cheaper than heapifying whole array
+ */
+template<typename T, typename C>
+void binary_heap<T, C>::_fix_appended(size_t from) {
+    size_t n = items.size();
+    node_map.reserve(n);
+    for (size_t i = from; i < n; i++) {
+        node_map[items[i]] = i;
+    }
+    HEAP_COUNT(_record_growth();)
+    size_t depth = 0;
+    while (((size_t) 1 << depth) < n) {
+        depth++;
+    }
+    if ((n - from) * depth < n) {
+        for (size_t i = from; i < n; i++) {
+            _push_top(i);
+        }
+    } else {
+        for (size_t i = n / 2; i-- > 0;) {
+            _heapify(i);
+        }
+    }
+}
+
+template<typename T, typename C>
+heap_stats binary_heap<T, C>::stats() const {
+#ifdef HEAP_STATS
+    return counters;
+#else
+    return heap_stats();
+#endif
+}
+
+#ifdef HEAP_STATS
+
+template<typename T, typename C>
+void binary_heap<T, C>::_record_sift(size_t levels) {
+    counters.sift_levels += levels;
+    counters.max_sift_depth = std::max(counters.max_sift_depth, levels);
+}
+
+template<typename T, typename C>
+void binary_heap<T, C>::_record_growth() {
+    counters.peak_size = std::max(counters.peak_size, items.size());
+    if (node_map.bucket_count() != buckets) {
+        counters.rehashes += buckets != 0;
+        buckets = node_map.bucket_count();
+    }
+}
+
+#endif
+
 
 #endif //ALGORITHMS_BINARY_HEAP_H
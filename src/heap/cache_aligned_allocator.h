@@ -0,0 +1,48 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_CACHE_ALIGNED_ALLOCATOR_H
+#define ALGORITHMS_CACHE_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/**
+ * allocator which puts every array on the beginning of a cache line
+ */
+template<typename T>
+struct cache_aligned_allocator {
+
+    typedef T value_type;
+
+    static const size_t CACHE_LINE = 64;
+
+    cache_aligned_allocator() = default;
+
+    template<typename U>
+    cache_aligned_allocator(const cache_aligned_allocator<U> &) {}
+
+    T *allocate(size_t n) {
+        // pointer returned by operator new is kept right before the aligned block
+        char *raw = (char *) ::operator new(n * sizeof(T) + CACHE_LINE + sizeof(void *));
+        uintptr_t p = ((uintptr_t) (raw + sizeof(void *)) + CACHE_LINE - 1) & ~(uintptr_t) (CACHE_LINE - 1);
+        ((void **) p)[-1] = raw;
+        return (T *) p;
+    }
+
+    void deallocate(T *p, size_t) {
+        ::operator delete(((void **) p)[-1]);
+    }
+
+    template<typename U>
+    bool operator==(const cache_aligned_allocator<U> &) const { return true; }
+
+    template<typename U>
+    bool operator!=(const cache_aligned_allocator<U> &) const { return false; }
+};
+
+
+#endif //ALGORITHMS_CACHE_ALIGNED_ALLOCATOR_H
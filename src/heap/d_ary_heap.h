@@ -0,0 +1,346 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_D_ARY_HEAP_H
+#define ALGORITHMS_D_ARY_HEAP_H
+
+#include "priority_queue.h"
+#include "cache_aligned_allocator.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * index of min among count consecutive children,
+ * specialized with SIMD for full groups of 4 and 8 ints
+ */
+template<typename T, size_t D>
+struct min_child {
+    static size_t index(const T *a, size_t count) {
+        size_t m = 0;
+        for (size_t i = 1; i < count; i++) {
+            if (a[i] < a[m]) {
+                m = i;
+            }
+        }
+        return m;
+    }
+};
+
+#if defined(__SSE2__)
+
+struct min_child_sse2 {
+    static __m128i min(__m128i a, __m128i b) {
+        __m128i lt = _mm_cmplt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, b));
+    }
+
+    // every lane of result holds min of lanes of v
+    static __m128i reduce(__m128i v) {
+        v = min(v, _mm_shuffle_epi32(v, 0x4E));
+        return min(v, _mm_shuffle_epi32(v, 0xB1));
+    }
+
+    static unsigned equal(__m128i a, __m128i b) {
+        return (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+    }
+};
+
+template<>
+struct min_child<int, 4> {
+    static size_t index(const int *a, size_t count) {
+        if (count < 4) {
+            return min_child<int, 0>::index(a, count);
+        }
+        __m128i v = _mm_loadu_si128((const __m128i *) a);
+        return (size_t) __builtin_ctz(min_child_sse2::equal(v, min_child_sse2::reduce(v)));
+    }
+};
+
+template<>
+struct min_child<int, 8> {
+    static size_t index(const int *a, size_t count) {
+        if (count < 8) {
+            return min_child<int, 0>::index(a, count);
+        }
+        __m128i lo = _mm_loadu_si128((const __m128i *) a);
+        __m128i hi = _mm_loadu_si128((const __m128i *) (a + 4));
+        __m128i m = min_child_sse2::reduce(min_child_sse2::min(lo, hi));
+        return (size_t) __builtin_ctz(min_child_sse2::equal(lo, m) | min_child_sse2::equal(hi, m) << 4);
+    }
+};
+
+#endif
+
+/**
+ * heap in which every node has D children, shallower than binary heap
+ * and children of a node are compared in one contiguous group,
+ * array starts on cache line and D - 1 padding slots put every group of children
+ * on offset which is a multiple of D, so small groups never straddle cache lines
+ */
+template<typename T, size_t D = 4>
+class d_ary_heap : public heap_base<d_ary_heap<T, D>, T> {
+
+    static_assert(D >= 2, "d_ary_heap needs at least two children per node");
+
+public:
+
+    using heap_base<d_ary_heap<T, D>, T>::meld;
+
+    /**
+     * creates empty heap
+     */
+    d_ary_heap();
+
+    /**
+     * creates heap from given items
+     * time complexity: O(n)
+     */
+    d_ary_heap(std::initializer_list<T> items);
+
+    /**
+     * check if heap is empty
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of items in heap
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * check if given key belongs to heap
+     * time complexity: O(1)
+     */
+    bool contains(const T &key) const;
+
+    /**
+     * @return min key
+     * time complexity: O(1)
+     */
+    T top() const;
+
+    /**
+     * insert new key to heap
+     * time complexity: O(log_D n)
+     */
+    void push(const T &key);
+
+    /**
+     * extract min key from heap
+     * time complexity: O(D log_D n)
+     */
+    void pop();
+
+    /**
+     * decrease value of given key
+     * time complexity: O(log_D n)
+     */
+    void decrease(const T &key, const T &new_key);
+
+    /**
+     * remove given key from heap
+     * time complexity: O(D log_D n)
+     */
+    void remove(const T &key);
+
+    /**
+     * insert all given keys, small batch is sifted up, large one rebuilds heap
+     * time complexity: O(min(k log_D n, n + k)) for k keys
+     */
+    void push_bulk(const std::vector<T> &keys);
+
+    /**
+     * move all keys of other heap to this one, h is left empty
+     * time complexity: O(min(m log_D n, n + m)) for h of size m
+     */
+    void meld(d_ary_heap &h);
+
+private:
+    static const size_t OFFSET = D - 1;
+    typedef std::vector<T, cache_aligned_allocator<T>> V;
+    typedef std::unordered_map<T, size_t> MAP;
+    // item i of heap is items[OFFSET + i], its children are items D * i + 1 ... D * i + D
+    V items;
+    MAP node_map;
+    size_t n;
+    T &_at(size_t i);
+    void _sift_up(size_t i, const T &key);
+    void _sift_down(size_t i, const T &key);
+    void _remove_at(size_t i);
+    void _fix_appended(size_t from);
+};
+
+template<typename T, size_t D>
+d_ary_heap<T, D>::d_ary_heap() : items(OFFSET), node_map(), n(0) {
+
+}
+
+template<typename T, size_t D>
+d_ary_heap<T, D>::d_ary_heap(std::initializer_list<T> items) : d_ary_heap() {
+    this->items.insert(this->items.end(), items.begin(), items.end());
+    _fix_appended(0);
+}
+
+template<typename T, size_t D>
+bool d_ary_heap<T, D>::empty() const {
+    return n == 0;
+}
+
+template<typename T, size_t D>
+size_t d_ary_heap<T, D>::size() const {
+    return n;
+}
+
+template<typename T, size_t D>
+bool d_ary_heap<T, D>::contains(const T &key) const {
+    return node_map.find(key) != node_map.end();
+}
+
+template<typename T, size_t D>
+T d_ary_heap<T, D>::top() const {
+    return items[OFFSET];
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::push(const T &key) {
+    items.push_back(key);
+    _sift_up(n++, key);
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::pop() {
+    _remove_at(0);
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::decrease(const T &key, const T &new_key) {
+    if (key < new_key) {
+        throw "cannot increase key";
+    }
+    size_t i = node_map[key];
+    node_map.erase(key);
+    _sift_up(i, new_key);
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::remove(const T &key) {
+    _remove_at(node_map[key]);
+}
+
+template<typename T, size_t D>
+T &d_ary_heap<T, D>::_at(size_t i) {
+    return items[OFFSET + i];
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::_remove_at(size_t i) {
+    node_map.erase(_at(i));
+    T last = items.back();
+    items.pop_back();
+    if (i == --n) {
+        return;
+    }
+    // last item fills the hole and moves up or down from there
+    if (i > 0 && last < _at((i - 1) / D)) {
+        _sift_up(i, last);
+    } else {
+        _sift_down(i, last);
+    }
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::_sift_up(size_t i, const T &key) {
+    while (i > 0) {
+        size_t parent = (i - 1) / D;
+        if (!(key < _at(parent))) {
+            break;
+        }
+        _at(i) = _at(parent);
+        node_map[_at(i)] = i;
+        i = parent;
+    }
+    _at(i) = key;
+    node_map[key] = i;
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::_sift_down(size_t i, const T &key) {
+    while (D * i + 1 < n) {
+        size_t first = D * i + 1;
+        size_t count = n - first < D ? n - first : D;
+        size_t min = first + min_child<T, D>::index(&_at(first), count);
+        if (!(_at(min) < key)) {
+            break;
+        }
+        _at(i) = _at(min);
+        node_map[_at(i)] = i;
+        i = min;
+    }
+    _at(i) = key;
+    node_map[key] = i;
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::push_bulk(const std::vector<T> &keys) {
+    size_t from = n;
+    items.insert(items.end(), keys.begin(), keys.end());
+    _fix_appended(from);
+}
+
+template<typename T, size_t D>
+void d_ary_heap<T, D>::meld(d_ary_heap &h) {
+    if (&h == this) return;
+    if (n < h.n) {
+        items.swap(h.items);
+        node_map.swap(h.node_map);
+        std::swap(n, h.n);
+    }
+    size_t from = n;
+    items.insert(items.end(), h.items.begin() + OFFSET, h.items.end());
+    h.items.resize(OFFSET);
+    h.node_map.clear();
+    h.n = 0;
+    _fix_appended(from);
+}
+
+/**
+ * restores heap after items from given index were appended,
+ * sifts them up one by one when it is cheaper than heapifying whole array
+ */
+template<typename T, size_t D>
+void d_ary_heap<T, D>::_fix_appended(size_t from) {
+    n = items.size() - OFFSET;
+    node_map.reserve(n);
+    size_t depth = 0;
+    for (size_t width = 1; width < n; width *= D) {
+        depth++;
+    }
+    if ((n - from) * depth < n) {
+        for (size_t i = from; i < n; i++) {
+            T key = _at(i);
+            _sift_up(i, key);
+        }
+    } else {
+        for (size_t i = n / D + 1; i-- > 0;) {
+            if (i < n) {
+                T key = _at(i);
+                _sift_down(i, key);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            node_map[_at(i)] = i;
+        }
+    }
+}
+
+
+#endif //ALGORITHMS_D_ARY_HEAP_H
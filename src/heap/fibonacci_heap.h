@@ -6,83 +6,123 @@
 #ifndef ALGORITHMS_FIBONACCI_HEAP_H
 #define ALGORITHMS_FIBONACCI_HEAP_H
 
+#include <algorithm>
+#include <functional>
 #include <unordered_map>
-#include <queue>
-#include <cmath>
+#include <vector>
 #include "priority_queue.h"
+#include "node_pool.h"
+#include "heap_stats.h"
 
-template<typename T>
-class fibonacci_heap : public priority_queue<T> {
+/**
+ * comparator C(a, b) is true when a leaves heap before b,
+ * std::less gives min heap and std::greater max heap,
+ * decrease moves key towards top in that order
+ */
+template<typename T, typename C = std::less<T>>
+class fibonacci_heap : public heap_base<fibonacci_heap<T, C>, T> {
 
 public:
 
+    using heap_base<fibonacci_heap<T, C>, T>::meld;
+
     /**
      * creates empty heap
      */
-    fibonacci_heap();
+    explicit fibonacci_heap(const C &compare = C());
+
+    ~fibonacci_heap();
 
     /**
      * check if heap is empty
      * time complexity: O(1)
      */
-    bool empty() const override;
+    bool empty() const;
 
     /**
      * @return number of items in heap
      * time complexity: O(1)
      */
-    size_t size() const override;
+    size_t size() const;
 
     /**
      * check if given key belongs to heap
      * time complexity: O(1)
      */
-    bool contains(const T &key) const override;
+    bool contains(const T &key) const;
 
     /**
-     * join two fibonacci heaps
-     * time complexity: O(1)
+     * join two fibonacci heaps, h is left empty,
+     * entries of smaller dictionary are moved to the larger one
+     * time complexity: O(min(n, m)), amortized O(log n) per key over any sequence of merges
      */
-    void merge(fibonacci_heap<T> &h);
+    void merge(fibonacci_heap<T, C> &h);
 
     /**
      * @return min key
      * time complexity: O(1)
      */
-    T top() const override;
+    T top() const;
 
     /**
      * insert new key to heap
      * time complexity: O(1)
      */
-    void push(const T &key) override;
+    void push(const T &key);
 
     /**
      * extract min key from heap
      * time complexity: O(log n)
      */
-    void pop() override;
+    void pop();
 
     /**
      * decrease value of given key
      * time complexity: O(1)
      */
-    void decrease(const T &key, const T &new_key) override;
+    void decrease(const T &key, const T &new_key);
 
     /**
      * remove given key from heap
      * time complexity: O(log n)
      */
-    void remove(const T &key) override;
+    void remove(const T &key);
+
+    /**
+     * insert all given keys
+     * time complexity: O(k) for k keys
+     */
+    void push_bulk(const std::vector<T> &keys);
+
+    /**
+     * same as merge
+     */
+    void meld(fibonacci_heap &h);
+
+    /**
+     * @return counters of operations since creation, zeros unless HEAP_STATS is defined
+     */
+    heap_stats stats() const;
 
 private:
     struct node;
-    typedef std::queue<node *> Q;
+    typedef std::vector<node *> V;
     typedef std::unordered_map<T, node *> MAP;
     MAP node_map;
     node *root;
     size_t n;
-    Q _get_all_siblings(node *x);
+    C compare;
+    node_pool<node> pool;
+    // scratch buffers reused by every pop: siblings of a list and roots by degree
+    V siblings;
+    V degrees;
+#ifdef HEAP_STATS
+    heap_stats counters;
+    size_t buckets = 0;
+    void _record_growth();
+#endif
+    bool _compare(const T &a, const T &b);
+    void _get_all_siblings(node *x);
     void _add_to_roots(node *x);
     void _check_for_root(node *x);
     void _remove_from_roots(node *x);
@@ -95,13 +135,20 @@ private:
     void _cut_cascade(node *x);
 };
 
-template<typename T>
-fibonacci_heap<T>::fibonacci_heap() : n(0), node_map(), root(nullptr) {
+template<typename T, typename C>
+fibonacci_heap<T, C>::fibonacci_heap(const C &compare) : node_map(), root(nullptr), n(0), compare(compare) {
 
 }
 
-template<typename T>
-struct fibonacci_heap<T>::node {
+template<typename T, typename C>
+fibonacci_heap<T, C>::~fibonacci_heap() {
+    for (auto item: node_map) {
+        pool.destroy(item.second);
+    }
+}
+
+template<typename T, typename C>
+struct fibonacci_heap<T, C>::node {
     T key;
     node *p, *c, *l, *r;
     int deg;
@@ -111,54 +158,66 @@ struct fibonacci_heap<T>::node {
 };
 
 
-template<typename T>
-bool fibonacci_heap<T>::empty() const {
+template<typename T, typename C>
+bool fibonacci_heap<T, C>::empty() const {
     return n == 0;
 }
 
-template<typename T>
-size_t fibonacci_heap<T>::size() const {
+template<typename T, typename C>
+size_t fibonacci_heap<T, C>::size() const {
     return n;
 }
 
-template<typename T>
-bool fibonacci_heap<T>::contains(const T &key) const {
+template<typename T, typename C>
+bool fibonacci_heap<T, C>::contains(const T &key) const {
     auto ptr = node_map.find(key);
     return ptr != node_map.end();
 }
 
-template<typename T>
-void fibonacci_heap<T>::merge(fibonacci_heap &h) {
-    if (h.root == nullptr) return;
-    node *temp_t = root->r;
-    node *temp_h = h.root->l;
-    root->r = h.root;
-    h.root->l = root;
-    temp_t->l = temp_h;
-    temp_h->r = temp_t;
-    _check_for_root(h.root);
+template<typename T, typename C>
+void fibonacci_heap<T, C>::merge(fibonacci_heap &h) {
+    if (&h == this || h.root == nullptr) return;
+    if (root == nullptr) {
+        root = h.root;
+    } else {
+        node *temp_t = root->r;
+        node *temp_h = h.root->l;
+        root->r = h.root;
+        h.root->l = root;
+        temp_t->l = temp_h;
+        temp_h->r = temp_t;
+        _check_for_root(h.root);
+    }
     this->n += h.n;
-    for (auto item : h.node_map) {
-        node_map[item.first] = item.second;
+    if (node_map.size() < h.node_map.size()) {
+        node_map.swap(h.node_map);
+        HEAP_COUNT(buckets = node_map.bucket_count();)
     }
+    node_map.insert(h.node_map.begin(), h.node_map.end());
+    HEAP_COUNT(_record_growth();)
+    pool.absorb(h.pool);
+    h.node_map.clear();
+    h.root = nullptr;
+    h.n = 0;
 }
 
-template<typename T>
-T fibonacci_heap<T>::top() const {
+template<typename T, typename C>
+T fibonacci_heap<T, C>::top() const {
     return root->key;
 }
 
-template<typename T>
-void fibonacci_heap<T>::push(const T &key) {
-    node *x = new node(key);
+template<typename T, typename C>
+void fibonacci_heap<T, C>::push(const T &key) {
+    node *x = pool.create(key);
     node_map[key] = x;
     _add_to_roots(x);
     _check_for_root(x);
     n++;
+    HEAP_COUNT(_record_growth();)
 }
 
-template<typename T>
-void fibonacci_heap<T>::_add_to_roots(fibonacci_heap::node *x) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_add_to_roots(fibonacci_heap::node *x) {
     if (root == nullptr) {
         root = x;
     } else {
@@ -170,21 +229,19 @@ void fibonacci_heap<T>::_add_to_roots(fibonacci_heap::node *x) {
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::_check_for_root(fibonacci_heap::node *x) {
-    if (root->key > x->key) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_check_for_root(fibonacci_heap::node *x) {
+    if (_compare(x->key, root->key)) {
         root = x;
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::pop() {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::pop() {
     node *z = root;
     if (z->c != nullptr) {
-        Q q = _get_all_siblings(z->c);
-        while (!q.empty()) {
-            node *c = q.front();
-            q.pop();
+        _get_all_siblings(z->c);
+        for (node *c: siblings) {
             _add_to_roots(c);
             c->p = nullptr;
         }
@@ -198,54 +255,52 @@ void fibonacci_heap<T>::pop() {
     }
     n--;
     node_map.erase(z->key);
-    delete z;
+    pool.destroy(z);
 }
 
-template<typename T>
-typename fibonacci_heap<T>::Q fibonacci_heap<T>::_get_all_siblings(fibonacci_heap::node *x) {
-    Q q;
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_get_all_siblings(fibonacci_heap::node *x) {
+    siblings.clear();
     node *y = x;
     do {
-        q.push(y);
+        siblings.push_back(y);
         y = y->r;
     } while (y != x);
-    return q;
 }
 
-template<typename T>
-void fibonacci_heap<T>::_remove_from_roots(fibonacci_heap::node *x) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_remove_from_roots(fibonacci_heap::node *x) {
     node *temp_l = x->l;
     node *temp_r = x->r;
     temp_l->r = temp_r;
     temp_r->l = temp_l;
 }
 
-template<typename T>
-void fibonacci_heap<T>::_consolidate() {
-    int max_deg = std::ceil(std::log2(n) + 1);
-    node **A = new node *[max_deg];
-    for (int i = 0; i < max_deg; i++) {
-        A[i] = nullptr;
-    }
-    Q q = _get_all_siblings(root);
-    while (!q.empty()) {
-        node *x = q.front();
-        q.pop();
-        int d = x->deg;
-        while (A[d] != nullptr) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_consolidate() {
+    // degrees grows to the highest degree seen and stays all nullptr between pops
+    V &A = degrees;
+    HEAP_COUNT(counters.consolidations++;)
+    _get_all_siblings(root);
+    for (node *x: siblings) {
+        size_t d = x->deg;
+        while (d < A.size() && A[d] != nullptr) {
             node *y = A[d];
-            if (x->key > y->key) {
+            if (_compare(y->key, x->key)) {
                 _swap(x, y);
             }
             _link(y, x);
             A[d] = nullptr;
             d = d + 1;
         }
+        if (d >= A.size()) {
+            A.resize(d + 1, nullptr);
+        }
         A[d] = x;
     }
 
     root = nullptr;
-    for (int i = 0; i < max_deg; i++) {
+    for (size_t i = 0; i < A.size(); i++) {
         if (A[i] != nullptr) {
             if (root == nullptr) {
                 root = A[i];
@@ -256,26 +311,28 @@ void fibonacci_heap<T>::_consolidate() {
                 _add_to_roots(A[i]);
                 _check_for_root(A[i]);
             }
+            A[i] = nullptr;
         }
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::_swap(fibonacci_heap::node *&x, fibonacci_heap::node *&y) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_swap(fibonacci_heap::node *&x, fibonacci_heap::node *&y) {
     node *temp = x;
     x = y;
     y = temp;
 }
 
-template<typename T>
-void fibonacci_heap<T>::_link(fibonacci_heap::node *y, fibonacci_heap::node *x) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_link(fibonacci_heap::node *y, fibonacci_heap::node *x) {
+    HEAP_COUNT(counters.links++;)
     _remove_from_roots(y);
     _add_to_children(x, y);
     y->mark = false;
 }
 
-template<typename T>
-void fibonacci_heap<T>::_add_to_children(fibonacci_heap::node *p, fibonacci_heap::node *c) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_add_to_children(fibonacci_heap::node *p, fibonacci_heap::node *c) {
     p->deg++;
     c->p = p;
     if (p->c == nullptr) {
@@ -291,37 +348,39 @@ void fibonacci_heap<T>::_add_to_children(fibonacci_heap::node *p, fibonacci_heap
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::decrease(const T &key, const T &new_key) {
-    if (key < new_key) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::decrease(const T &key, const T &new_key) {
+    if (compare(key, new_key)) {
         throw "cannot increase key";
     }
     node *x = node_map[key];
     node_map.erase(key);
     x->key = new_key;
     node_map[new_key] = x;
+    HEAP_COUNT(_record_growth();)
     node *y = x->p;
-    if (y != nullptr && x->key < y->key) {
+    if (y != nullptr && _compare(x->key, y->key)) {
         _cut(x ,y);
         _cut_cascade(y);
     }
     _check_for_root(x);
 }
 
-template<typename T>
-void fibonacci_heap<T>::_cut(fibonacci_heap::node *x, fibonacci_heap::node *y) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_cut(fibonacci_heap::node *x, fibonacci_heap::node *y) {
     _remove_from_children(y, x);
     _add_to_roots(x);
     x->mark = false;
 }
 
-template<typename T>
-void fibonacci_heap<T>::_remove_from_children(node *p, node *c) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_remove_from_children(node *p, node *c) {
     node *temp_l = c->l;
     node *temp_r = c->r;
     temp_l->r = temp_r;
     temp_r->l = temp_l;
     c->p = nullptr;
+    p->deg--;
     if (p->c == c) {
         p->c = temp_l;
     }
@@ -330,24 +389,73 @@ void fibonacci_heap<T>::_remove_from_children(node *p, node *c) {
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::_cut_cascade(fibonacci_heap::node *x) {
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_cut_cascade(fibonacci_heap::node *x) {
     node *z = x->p;
     if (z != nullptr) {
         if (x->mark == false) {
             x->mark = true;
         } else {
+            HEAP_COUNT(counters.cascading_cuts++;)
             _cut(x, z);
             _cut_cascade(z);
         }
     }
 }
 
-template<typename T>
-void fibonacci_heap<T>::remove(const T &key) {
-    decrease(key, root->key - 1);
+template<typename T, typename C>
+void fibonacci_heap<T, C>::remove(const T &key) {
+    // node is cut to roots and made root by force, as if its key was smaller than any other
+    node *x = node_map[key];
+    node *y = x->p;
+    if (y != nullptr) {
+        _cut(x, y);
+        _cut_cascade(y);
+    }
+    root = x;
     pop();
 }
 
+template<typename T, typename C>
+void fibonacci_heap<T, C>::push_bulk(const std::vector<T> &keys) {
+    node_map.reserve(n + keys.size());
+    for (auto &key: keys) {
+        push(key);
+    }
+}
+
+template<typename T, typename C>
+void fibonacci_heap<T, C>::meld(fibonacci_heap &h) {
+    merge(h);
+}
+
+template<typename T, typename C>
+heap_stats fibonacci_heap<T, C>::stats() const {
+#ifdef HEAP_STATS
+    return counters;
+#else
+    return heap_stats();
+#endif
+}
+
+template<typename T, typename C>
+bool fibonacci_heap<T, C>::_compare(const T &a, const T &b) {
+    HEAP_COUNT(counters.comparisons++;)
+    return compare(a, b);
+}
+
+#ifdef HEAP_STATS
+
+template<typename T, typename C>
+void fibonacci_heap<T, C>::_record_growth() {
+    counters.peak_size = std::max(counters.peak_size, n);
+    if (node_map.bucket_count() != buckets) {
+        counters.rehashes += buckets != 0;
+        buckets = node_map.bucket_count();
+    }
+}
+
+#endif
+
 
 #endif //ALGORITHMS_FIBONACCI_HEAP_H
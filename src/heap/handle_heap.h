@@ -0,0 +1,203 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_HANDLE_HEAP_H
+#define ALGORITHMS_HANDLE_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "heap_sift.h"
+#include "node_pool.h"
+
+/**
+ * binary heap of values with separate priorities, values are built in place in a pool
+ * and never move, heap array holds only (priority, handle) pairs, so sifting copies
+ * small entries and large values need no hashing or copying,
+ * handle returned by push stays valid until its value leaves heap,
+ * comparator C(a, b) is true when priority a leaves heap before b
+ */
+template<typename P, typename V, typename C = std::less<P>>
+class handle_heap {
+
+    struct node;
+
+public:
+
+    typedef node *HANDLE;
+
+    /**
+     * creates empty heap
+     */
+    explicit handle_heap(const C &compare = C());
+
+    ~handle_heap();
+
+    handle_heap(const handle_heap &) = delete;
+
+    handle_heap &operator=(const handle_heap &) = delete;
+
+    /**
+     * check if heap is empty
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of items in heap
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * @return handle of item with min priority
+     * time complexity: O(1)
+     */
+    HANDLE top() const;
+
+    /**
+     * @return value of item with given handle
+     * time complexity: O(1)
+     */
+    V &value(HANDLE h);
+
+    const V &value(HANDLE h) const;
+
+    /**
+     * @return priority of item with given handle
+     * time complexity: O(1)
+     */
+    const P &priority(HANDLE h) const;
+
+    /**
+     * insert item with value built from given arguments
+     * @return handle of new item
+     * time complexity: O(log n)
+     */
+    template<typename... A>
+    HANDLE push(const P &priority, A &&... args);
+
+    /**
+     * extract item with min priority, its value is destroyed
+     * time complexity: O(log n)
+     */
+    void pop();
+
+    /**
+     * decrease priority of item with given handle
+     * time complexity: O(log n)
+     */
+    void decrease(HANDLE h, const P &new_priority);
+
+    /**
+     * remove item with given handle from heap, its value is destroyed
+     * time complexity: O(log n)
+     */
+    void remove(HANDLE h);
+
+private:
+    struct entry {
+        P priority;
+        node *handle;
+    };
+    std::vector<entry> items;
+    node_pool<node> pool;
+    C compare;
+    // stores index of moved entry in its node
+    struct placer {
+        void operator()(const entry &e, size_t i) const { e.handle->position = i; }
+    };
+    void _remove_at(size_t i);
+};
+
+template<typename P, typename V, typename C>
+struct handle_heap<P, V, C>::node {
+    V value;
+    // index of entry of this node in items
+    size_t position;
+
+    template<typename... A>
+    explicit node(A &&... args) : value(std::forward<A>(args)...), position(0) {}
+};
+
+template<typename P, typename V, typename C>
+handle_heap<P, V, C>::handle_heap(const C &compare) : items(), compare(compare) {
+
+}
+
+template<typename P, typename V, typename C>
+handle_heap<P, V, C>::~handle_heap() {
+    for (auto &e: items) {
+        pool.destroy(e.handle);
+    }
+}
+
+template<typename P, typename V, typename C>
+bool handle_heap<P, V, C>::empty() const {
+    return items.empty();
+}
+
+template<typename P, typename V, typename C>
+size_t handle_heap<P, V, C>::size() const {
+    return items.size();
+}
+
+template<typename P, typename V, typename C>
+typename handle_heap<P, V, C>::HANDLE handle_heap<P, V, C>::top() const {
+    return items.front().handle;
+}
+
+template<typename P, typename V, typename C>
+V &handle_heap<P, V, C>::value(HANDLE h) {
+    return h->value;
+}
+
+template<typename P, typename V, typename C>
+const V &handle_heap<P, V, C>::value(HANDLE h) const {
+    return h->value;
+}
+
+template<typename P, typename V, typename C>
+const P &handle_heap<P, V, C>::priority(HANDLE h) const {
+    return items[h->position].priority;
+}
+
+template<typename P, typename V, typename C>
+template<typename... A>
+typename handle_heap<P, V, C>::HANDLE handle_heap<P, V, C>::push(const P &priority, A &&... args) {
+    node *x = pool.create(std::forward<A>(args)...);
+    items.push_back({priority, x});
+    sift_up(items, items.size() - 1, items.back(), compare, placer());
+    return x;
+}
+
+template<typename P, typename V, typename C>
+void handle_heap<P, V, C>::pop() {
+    _remove_at(0);
+}
+
+template<typename P, typename V, typename C>
+void handle_heap<P, V, C>::decrease(HANDLE h, const P &new_priority) {
+    size_t i = h->position;
+    if (compare(items[i].priority, new_priority)) {
+        throw "cannot increase key";
+    }
+    sift_up(items, i, {new_priority, h}, compare, placer());
+}
+
+template<typename P, typename V, typename C>
+void handle_heap<P, V, C>::remove(HANDLE h) {
+    _remove_at(h->position);
+}
+
+template<typename P, typename V, typename C>
+void handle_heap<P, V, C>::_remove_at(size_t i) {
+    pool.destroy(items[i].handle);
+    sift_remove(items, i, compare, placer());
+}
+
+
+#endif //ALGORITHMS_HANDLE_HEAP_H
@@ -0,0 +1,79 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_HEAP_SIFT_H
+#define ALGORITHMS_HEAP_SIFT_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * sifting of binary heaps which keep entries with priority field in vector
+ * and track index of every entry, place(e, i) is called whenever entry e
+ * is stored at index i, comparator C(a, b) is true when priority a leaves heap before b
+ */
+
+/**
+ * puts entry e at index i and moves it up while it leaves heap before its parent
+ * time complexity: O(log n)
+ */
+template<typename E, typename C, typename P>
+void sift_up(std::vector<E> &items, size_t i, E e, const C &compare, P place) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!compare(e.priority, items[parent].priority)) {
+            break;
+        }
+        items[i] = items[parent];
+        place(items[i], i);
+        i = parent;
+    }
+    items[i] = e;
+    place(e, i);
+}
+
+/**
+ * puts entry e at index i and moves it down while one of its children leaves heap before it
+ * time complexity: O(log n)
+ */
+template<typename E, typename C, typename P>
+void sift_down(std::vector<E> &items, size_t i, E e, const C &compare, P place) {
+    size_t n = items.size();
+    while (2 * i + 1 < n) {
+        size_t min = 2 * i + 1;
+        if (min + 1 < n && compare(items[min + 1].priority, items[min].priority)) {
+            min++;
+        }
+        if (!compare(items[min].priority, e.priority)) {
+            break;
+        }
+        items[i] = items[min];
+        place(items[i], i);
+        i = min;
+    }
+    items[i] = e;
+    place(e, i);
+}
+
+/**
+ * removes entry at index i, last entry fills the hole and moves up or down from there
+ * time complexity: O(log n)
+ */
+template<typename E, typename C, typename P>
+void sift_remove(std::vector<E> &items, size_t i, const C &compare, P place) {
+    E last = items.back();
+    items.pop_back();
+    if (i == items.size()) {
+        return;
+    }
+    if (i > 0 && compare(last.priority, items[(i - 1) / 2].priority)) {
+        sift_up(items, i, last, compare, place);
+    } else {
+        sift_down(items, i, last, compare, place);
+    }
+}
+
+
+#endif //ALGORITHMS_HEAP_SIFT_H
@@ -0,0 +1,43 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_HEAP_STATS_H
+#define ALGORITHMS_HEAP_STATS_H
+
+#include <cstddef>
+
+/**
+ * counters of heap operations for choosing heap for a workload,
+ * heaps collect them only when HEAP_STATS is defined (cmake -DHEAP_STATS=ON, the same
+ * for the whole program), otherwise counting compiles to nothing and all counters are zero
+ */
+struct heap_stats {
+    // comparisons of keys
+    size_t comparisons = 0;
+    // items exchanged between slots of array
+    size_t swaps = 0;
+    // trees linked under other trees
+    size_t links = 0;
+    // levels passed by all sifts together and by the longest one
+    size_t sift_levels = 0;
+    size_t max_sift_depth = 0;
+    // passes joining trees of equal degree after pop
+    size_t consolidations = 0;
+    // marked parents cut after decrease
+    size_t cascading_cuts = 0;
+    // most items held at once
+    size_t peak_size = 0;
+    // times key dictionary grew its bucket array
+    size_t rehashes = 0;
+};
+
+#ifdef HEAP_STATS
+#define HEAP_COUNT(...) __VA_ARGS__
+#else
+#define HEAP_COUNT(...)
+#endif
+
+
+#endif //ALGORITHMS_HEAP_STATS_H
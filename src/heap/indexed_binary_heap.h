@@ -0,0 +1,187 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_INDEXED_BINARY_HEAP_H
+#define ALGORITHMS_INDEXED_BINARY_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "heap_sift.h"
+
+/**
+ * binary heap of items addressed by dense integer handles (e.g. vertex ids),
+ * positions of handles are kept in flat array instead of dictionary,
+ * so many items can share the same priority and no operation hashes,
+ * comparator C(a, b) is true when priority a leaves heap before b
+ */
+template<typename T, typename C = std::less<T>>
+class indexed_binary_heap {
+
+public:
+
+    typedef size_t HANDLE;
+
+    /**
+     * creates empty heap
+     */
+    explicit indexed_binary_heap(const C &compare = C());
+
+    /**
+     * creates empty heap with room for handles [0, n)
+     */
+    explicit indexed_binary_heap(size_t n, const C &compare = C());
+
+    /**
+     * check if heap is empty
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of items in heap
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * check if item with given handle is in heap
+     * time complexity: O(1)
+     */
+    bool contains(HANDLE h) const;
+
+    /**
+     * @return handle of item with min priority
+     * time complexity: O(1)
+     */
+    HANDLE top() const;
+
+    /**
+     * @return priority of item with given handle which is in heap
+     * time complexity: O(1)
+     */
+    const T &priority(HANDLE h) const;
+
+    /**
+     * insert item with given handle, handle cannot be already in heap
+     * time complexity: O(log n)
+     */
+    void push(HANDLE h, const T &priority);
+
+    /**
+     * extract item with min priority
+     * time complexity: O(log n)
+     */
+    void pop();
+
+    /**
+     * decrease priority of item with given handle
+     * time complexity: O(log n)
+     */
+    void decrease(HANDLE h, const T &new_priority);
+
+    /**
+     * remove item with given handle from heap
+     * time complexity: O(log n)
+     */
+    void remove(HANDLE h);
+
+private:
+    struct entry {
+        T priority;
+        HANDLE handle;
+    };
+    static const size_t NONE = (size_t) -1;
+    std::vector<entry> items;
+    // position of every handle in items or NONE
+    std::vector<size_t> position;
+    C compare;
+    // stores index of moved entry in position
+    struct placer {
+        std::vector<size_t> &position;
+
+        void operator()(const entry &e, size_t i) const { position[e.handle] = i; }
+    };
+    void _remove_at(size_t i);
+};
+
+template<typename T, typename C>
+const size_t indexed_binary_heap<T, C>::NONE;
+
+template<typename T, typename C>
+indexed_binary_heap<T, C>::indexed_binary_heap(const C &compare) : items(), position(), compare(compare) {
+
+}
+
+template<typename T, typename C>
+indexed_binary_heap<T, C>::indexed_binary_heap(size_t n, const C &compare) : items(), position(n, NONE),
+                                                                          compare(compare) {
+    items.reserve(n);
+}
+
+template<typename T, typename C>
+bool indexed_binary_heap<T, C>::empty() const {
+    return items.empty();
+}
+
+template<typename T, typename C>
+size_t indexed_binary_heap<T, C>::size() const {
+    return items.size();
+}
+
+template<typename T, typename C>
+bool indexed_binary_heap<T, C>::contains(HANDLE h) const {
+    return h < position.size() && position[h] != NONE;
+}
+
+template<typename T, typename C>
+typename indexed_binary_heap<T, C>::HANDLE indexed_binary_heap<T, C>::top() const {
+    return items.front().handle;
+}
+
+template<typename T, typename C>
+const T &indexed_binary_heap<T, C>::priority(HANDLE h) const {
+    return items[position[h]].priority;
+}
+
+template<typename T, typename C>
+void indexed_binary_heap<T, C>::push(HANDLE h, const T &priority) {
+    if (contains(h)) {
+        throw "handle already in heap";
+    }
+    if (h >= position.size()) {
+        position.resize(h + 1, NONE);
+    }
+    items.push_back({priority, h});
+    sift_up(items, items.size() - 1, items.back(), compare, placer{position});
+}
+
+template<typename T, typename C>
+void indexed_binary_heap<T, C>::pop() {
+    _remove_at(0);
+}
+
+template<typename T, typename C>
+void indexed_binary_heap<T, C>::decrease(HANDLE h, const T &new_priority) {
+    size_t i = position[h];
+    if (compare(items[i].priority, new_priority)) {
+        throw "cannot increase key";
+    }
+    sift_up(items, i, {new_priority, h}, compare, placer{position});
+}
+
+template<typename T, typename C>
+void indexed_binary_heap<T, C>::remove(HANDLE h) {
+    _remove_at(position[h]);
+}
+
+template<typename T, typename C>
+void indexed_binary_heap<T, C>::_remove_at(size_t i) {
+    position[items[i].handle] = NONE;
+    sift_remove(items, i, compare, placer{position});
+}
+
+
+#endif //ALGORITHMS_INDEXED_BINARY_HEAP_H
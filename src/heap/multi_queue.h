@@ -0,0 +1,204 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_MULTI_QUEUE_H
+#define ALGORITHMS_MULTI_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cache_aligned_allocator.h"
+
+/**
+ * relaxed priority queue for many producer and consumer threads,
+ * keys are spread over threads * relaxation small heaps guarded by own locks,
+ * push goes to random heap, pop takes smaller top of two random heaps,
+ * so threads rarely wait for each other but popped key is only one of the smallest:
+ * its expected rank is O(number of heaps), relaxation = 1 is the least relaxed
+ *
+ * unlike priority_queue keys need not be unique and there is no decrease or remove,
+ * pop hands out the key it extracted, since key seen by top could be taken by other thread
+ */
+template<typename T>
+class multi_queue {
+
+public:
+
+    /**
+     * @param threads number of threads expected to use queue at once
+     * @param relaxation number of heaps per thread, more heaps means less waiting
+     * and less accurate pop
+     */
+    explicit multi_queue(unsigned threads = std::max(1u, std::thread::hardware_concurrency()),
+                         unsigned relaxation = 2);
+
+    multi_queue(const multi_queue &) = delete;
+
+    multi_queue &operator=(const multi_queue &) = delete;
+
+    /**
+     * check if queue is empty, exact only when no other thread changes it
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of keys in queue, exact only when no other thread changes it
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * @return number of internal heaps
+     */
+    size_t heaps() const;
+
+    /**
+     * insert new key to queue
+     * time complexity: O(log n) without contention
+     */
+    void push(const T &key);
+
+    /**
+     * extract one of the smallest keys
+     * @param key set to extracted key
+     * @return false if queue was empty
+     * time complexity: O(log n) without contention, O(heaps) when queue is almost empty
+     */
+    bool pop(T &key);
+
+    /**
+     * @param key set to min key of queue, which may be taken by other thread right away
+     * @return false if queue was empty
+     * time complexity: O(heaps)
+     */
+    bool top(T &key) const;
+
+private:
+    // every heap on its own cache lines, so locking one does not slow down neighbours
+    struct alignas(64) shard {
+        mutable std::mutex m;
+        // binary heap ordered by std::greater, min on front
+        std::vector<T> items;
+    };
+    std::vector<shard, cache_aligned_allocator<shard>> shards;
+    std::atomic<size_t> n;
+    static uint64_t _random();
+    bool _pop_from(shard &s, T &key);
+};
+
+template<typename T>
+multi_queue<T>::multi_queue(unsigned threads, unsigned relaxation)
+        : shards(std::max(1u, threads * relaxation)), n(0) {
+
+}
+
+template<typename T>
+bool multi_queue<T>::empty() const {
+    return n.load(std::memory_order_relaxed) == 0;
+}
+
+template<typename T>
+size_t multi_queue<T>::size() const {
+    return n.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+size_t multi_queue<T>::heaps() const {
+    return shards.size();
+}
+
+template<typename T>
+void multi_queue<T>::push(const T &key) {
+    // locked heap is skipped, there is always other one to try
+    while (true) {
+        shard &s = shards[_random() % shards.size()];
+        std::unique_lock<std::mutex> lock(s.m, std::try_to_lock);
+        if (lock.owns_lock()) {
+            s.items.push_back(key);
+            std::push_heap(s.items.begin(), s.items.end(), std::greater<T>());
+            n++;
+            return;
+        }
+    }
+}
+
+template<typename T>
+bool multi_queue<T>::pop(T &key) {
+    size_t count = shards.size();
+    for (size_t attempt = 0; attempt < 2 * count; attempt++) {
+        shard &a = shards[_random() % count];
+        shard &b = shards[_random() % count];
+        std::unique_lock<std::mutex> lock_a(a.m, std::try_to_lock);
+        if (!lock_a.owns_lock()) continue;
+        if (&a == &b) {
+            if (_pop_from(a, key)) return true;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock_b(b.m, std::try_to_lock);
+        if (!lock_b.owns_lock()) {
+            if (_pop_from(a, key)) return true;
+            continue;
+        }
+        if (b.items.empty() || (!a.items.empty() && !(b.items.front() < a.items.front()))) {
+            if (_pop_from(a, key)) return true;
+        } else {
+            if (_pop_from(b, key)) return true;
+        }
+    }
+    // random choices keep missing keys, queue is empty or almost empty
+    for (shard &s: shards) {
+        std::lock_guard<std::mutex> lock(s.m);
+        if (_pop_from(s, key)) return true;
+    }
+    return false;
+}
+
+template<typename T>
+bool multi_queue<T>::top(T &key) const {
+    bool found = false;
+    for (const shard &s: shards) {
+        std::lock_guard<std::mutex> lock(s.m);
+        if (!s.items.empty() && (!found || s.items.front() < key)) {
+            key = s.items.front();
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * pops min of given heap, its lock has to be held
+ */
+template<typename T>
+bool multi_queue<T>::_pop_from(shard &s, T &key) {
+    if (s.items.empty()) {
+        return false;
+    }
+    std::pop_heap(s.items.begin(), s.items.end(), std::greater<T>());
+    key = s.items.back();
+    s.items.pop_back();
+    n--;
+    return true;
+}
+
+/**
+ * xorshift generator with state per thread
+ */
+template<typename T>
+uint64_t multi_queue<T>::_random() {
+    static thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+
+#endif //ALGORITHMS_MULTI_QUEUE_H
@@ -0,0 +1,139 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_NODE_POOL_H
+#define ALGORITHMS_NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * slab allocator for nodes of linked heaps, nodes are carved from growing slabs
+ * and destroyed nodes go to free list for reuse, memory is returned when pool dies
+ */
+template<typename N>
+class node_pool {
+
+public:
+
+    /**
+     * creates empty pool, first slab is allocated with first node
+     */
+    node_pool();
+
+    ~node_pool();
+
+    node_pool(const node_pool &) = delete;
+
+    node_pool &operator=(const node_pool &) = delete;
+
+    /**
+     * @return new node constructed from given arguments
+     * time complexity: amortized O(1)
+     */
+    template<typename... A>
+    N *create(A &&... args);
+
+    /**
+     * destroys node created by this pool and keeps its memory for reuse
+     * time complexity: O(1)
+     */
+    void destroy(N *x);
+
+    /**
+     * takes over all memory of other pool, nodes created by other stay valid
+     * and have to be destroyed by this pool from now on
+     * time complexity: O(number of slabs of other)
+     */
+    void absorb(node_pool &other);
+
+private:
+    union slot {
+        slot *next;
+        alignas(N) unsigned char data[sizeof(N)];
+    };
+    static const size_t FIRST_SLAB = 64;
+    static const size_t MAX_SLAB = 4096;
+    std::vector<slot *> slabs;
+    // free list of destroyed nodes
+    slot *head, *tail;
+    // unused part of the last slab
+    slot *next;
+    size_t left;
+    size_t slab_size;
+};
+
+template<typename N>
+const size_t node_pool<N>::FIRST_SLAB;
+
+template<typename N>
+const size_t node_pool<N>::MAX_SLAB;
+
+template<typename N>
+node_pool<N>::node_pool() : slabs(), head(nullptr), tail(nullptr), next(nullptr), left(0), slab_size(FIRST_SLAB) {
+
+}
+
+template<typename N>
+node_pool<N>::~node_pool() {
+    for (slot *s: slabs) {
+        ::operator delete(s);
+    }
+}
+
+template<typename N>
+template<typename... A>
+N *node_pool<N>::create(A &&... args) {
+    slot *s;
+    if (head != nullptr) {
+        s = head;
+        head = head->next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+    } else {
+        if (left == 0) {
+            next = (slot *) ::operator new(slab_size * sizeof(slot));
+            slabs.push_back(next);
+            left = slab_size;
+            slab_size = slab_size < MAX_SLAB ? 2 * slab_size : MAX_SLAB;
+        }
+        s = next++;
+        left--;
+    }
+    return new(s->data) N(std::forward<A>(args)...);
+}
+
+template<typename N>
+void node_pool<N>::destroy(N *x) {
+    x->~N();
+    slot *s = (slot *) x;
+    s->next = head;
+    head = s;
+    if (tail == nullptr) {
+        tail = s;
+    }
+}
+
+template<typename N>
+void node_pool<N>::absorb(node_pool &other) {
+    slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+    if (other.head != nullptr) {
+        other.tail->next = head;
+        if (tail == nullptr) {
+            tail = other.tail;
+        }
+        head = other.head;
+    }
+    // unused part of last slab of other is dropped, it is freed with the slab
+    other.slabs.clear();
+    other.head = other.tail = other.next = nullptr;
+    other.left = 0;
+}
+
+
+#endif //ALGORITHMS_NODE_POOL_H
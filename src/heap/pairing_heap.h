@@ -0,0 +1,304 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_PAIRING_HEAP_H
+#define ALGORITHMS_PAIRING_HEAP_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "priority_queue.h"
+#include "node_pool.h"
+
+/**
+ * self adjusting heap made of one multiway tree, nodes are addressed by keys
+ * the same way as in fibonacci heap, so it can replace it directly,
+ * amortized bounds are weaker but constant factors are much smaller in practice,
+ * comparator C(a, b) is true when a leaves heap before b
+ */
+template<typename T, typename C = std::less<T>>
+class pairing_heap : public heap_base<pairing_heap<T, C>, T> {
+
+public:
+
+    using heap_base<pairing_heap<T, C>, T>::meld;
+
+    /**
+     * creates empty heap
+     */
+    explicit pairing_heap(const C &compare = C());
+
+    ~pairing_heap();
+
+    /**
+     * check if heap is empty
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of items in heap
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * check if given key belongs to heap
+     * time complexity: O(1)
+     */
+    bool contains(const T &key) const;
+
+    /**
+     * join two pairing heaps, h is left empty,
+     * entries of smaller dictionary are moved to the larger one
+     * time complexity: O(min(n, m)), amortized O(log n) per key over any sequence of merges
+     */
+    void merge(pairing_heap<T, C> &h);
+
+    /**
+     * @return min key
+     * time complexity: O(1)
+     */
+    T top() const;
+
+    /**
+     * insert new key to heap
+     * time complexity: O(1)
+     */
+    void push(const T &key);
+
+    /**
+     * extract min key from heap
+     * time complexity: amortized O(log n)
+     */
+    void pop();
+
+    /**
+     * decrease value of given key
+     * time complexity: O(1), amortized O(log n) (paid by following pop)
+     */
+    void decrease(const T &key, const T &new_key);
+
+    /**
+     * remove given key from heap
+     * time complexity: amortized O(log n)
+     */
+    void remove(const T &key);
+
+    /**
+     * insert all given keys
+     * time complexity: O(k) for k keys
+     */
+    void push_bulk(const std::vector<T> &keys);
+
+    /**
+     * same as merge
+     */
+    void meld(pairing_heap &h);
+
+private:
+    struct node;
+    typedef std::vector<node *> V;
+    typedef std::unordered_map<T, node *> MAP;
+    MAP node_map;
+    node *root;
+    size_t n;
+    C compare;
+    node_pool<node> pool;
+    // scratch buffer reused by every pop: subtrees paired in first pass
+    V pairs;
+    node *_link(node *x, node *y);
+    node *_merge_pairs(node *x);
+    void _detach(node *x);
+};
+
+template<typename T, typename C>
+pairing_heap<T, C>::pairing_heap(const C &compare) : node_map(), root(nullptr), n(0), compare(compare) {
+
+}
+
+template<typename T, typename C>
+pairing_heap<T, C>::~pairing_heap() {
+    for (auto item: node_map) {
+        pool.destroy(item.second);
+    }
+}
+
+/**
+ * children of a node form list starting at c and linked by s,
+ * p is parent for first child and previous sibling for others
+ */
+template<typename T, typename C>
+struct pairing_heap<T, C>::node {
+    T key;
+    node *p, *c, *s;
+
+    explicit node(const T &key) : key(key), p(nullptr), c(nullptr), s(nullptr) {}
+};
+
+template<typename T, typename C>
+bool pairing_heap<T, C>::empty() const {
+    return n == 0;
+}
+
+template<typename T, typename C>
+size_t pairing_heap<T, C>::size() const {
+    return n;
+}
+
+template<typename T, typename C>
+bool pairing_heap<T, C>::contains(const T &key) const {
+    auto ptr = node_map.find(key);
+    return ptr != node_map.end();
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::merge(pairing_heap &h) {
+    if (&h == this || h.root == nullptr) return;
+    root = _link(root, h.root);
+    n += h.n;
+    if (node_map.size() < h.node_map.size()) {
+        node_map.swap(h.node_map);
+    }
+    node_map.insert(h.node_map.begin(), h.node_map.end());
+    pool.absorb(h.pool);
+    h.node_map.clear();
+    h.root = nullptr;
+    h.n = 0;
+}
+
+template<typename T, typename C>
+T pairing_heap<T, C>::top() const {
+    return root->key;
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::push(const T &key) {
+    node *x = pool.create(key);
+    node_map[key] = x;
+    root = _link(root, x);
+    n++;
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::pop() {
+    node *z = root;
+    root = _merge_pairs(z->c);
+    n--;
+    node_map.erase(z->key);
+    pool.destroy(z);
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::decrease(const T &key, const T &new_key) {
+    if (compare(key, new_key)) {
+        throw "cannot increase key";
+    }
+    node *x = node_map[key];
+    node_map.erase(key);
+    x->key = new_key;
+    node_map[new_key] = x;
+    if (x != root) {
+        _detach(x);
+        root = _link(root, x);
+    }
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::remove(const T &key) {
+    node *x = node_map[key];
+    if (x == root) {
+        pop();
+        return;
+    }
+    _detach(x);
+    root = _link(root, _merge_pairs(x->c));
+    n--;
+    node_map.erase(key);
+    pool.destroy(x);
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::push_bulk(const std::vector<T> &keys) {
+    node_map.reserve(n + keys.size());
+    for (auto &key: keys) {
+        push(key);
+    }
+}
+
+template<typename T, typename C>
+void pairing_heap<T, C>::meld(pairing_heap &h) {
+    merge(h);
+}
+
+/**
+ * makes root with greater key first child of the other one, both are whole trees
+ * @return root of joined tree
+ */
+template<typename T, typename C>
+typename pairing_heap<T, C>::node *pairing_heap<T, C>::_link(node *x, node *y) {
+    if (x == nullptr) return y;
+    if (y == nullptr) return x;
+    if (compare(y->key, x->key)) {
+        node *temp = x;
+        x = y;
+        y = temp;
+    }
+    y->p = x;
+    y->s = x->c;
+    if (x->c != nullptr) {
+        x->c->p = y;
+    }
+    x->c = y;
+    x->p = x->s = nullptr;
+    return x;
+}
+
+/**
+ * joins list of siblings into one tree, first pass links pairs from left to right,
+ * second pass links results from right to left
+ * @return root of joined tree
+ */
+template<typename T, typename C>
+typename pairing_heap<T, C>::node *pairing_heap<T, C>::_merge_pairs(node *x) {
+    pairs.clear();
+    while (x != nullptr) {
+        node *y = x->s;
+        node *next = y == nullptr ? nullptr : y->s;
+        x->s = nullptr;
+        if (y != nullptr) {
+            y->s = nullptr;
+        }
+        pairs.push_back(_link(x, y));
+        x = next;
+    }
+    node *result = nullptr;
+    for (size_t i = pairs.size(); i-- > 0;) {
+        result = _link(pairs[i], result);
+    }
+    if (result != nullptr) {
+        result->p = nullptr;
+    }
+    return result;
+}
+
+/**
+ * cuts subtree of x (which is not root) from its parent
+ */
+template<typename T, typename C>
+void pairing_heap<T, C>::_detach(node *x) {
+    if (x->p->c == x) {
+        x->p->c = x->s;
+    } else {
+        x->p->s = x->s;
+    }
+    if (x->s != nullptr) {
+        x->s->p = x->p;
+    }
+    x->p = x->s = nullptr;
+}
+
+
+#endif //ALGORITHMS_PAIRING_HEAP_H
@@ -6,11 +6,82 @@
 #ifndef ALGORITHMS_PRIORITY_QUEUE_H
 #define ALGORITHMS_PRIORITY_QUEUE_H
 
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @return all keys of given queue in order of extraction, queue is left empty
+ * time complexity: O(size of queue * cost of pop)
+ */
+template<typename Q>
+std::vector<typename std::decay<decltype(std::declval<Q &>().top())>::type> take_all(Q &q) {
+    std::vector<typename std::decay<decltype(q.top())>::type> keys;
+    keys.reserve(q.size());
+    while (!q.empty()) {
+        keys.push_back(q.top());
+        q.pop();
+    }
+    return keys;
+}
+
+/**
+ * base of heaps addressed by keys, heaps derive from it with their own type as D
+ * and provide (without virtual calls):
+ * empty, size, contains, top, push, pop, decrease, remove, push_bulk and meld with heap of the same type,
+ * so algorithms templated on heap type get calls resolved and inlined at compile time,
+ * queue_adapter turns any of them into priority_queue when type is known only at runtime
+ */
+template<typename D, typename T>
+class heap_base {
+
+public:
+
+    typedef T KEY;
+
+    /**
+     * insert keys from range [first, last)
+     */
+    template<typename I>
+    void build(I first, I last) {
+        _self().push_bulk(std::vector<T>(first, last));
+    }
+
+    /**
+     * move all keys of queue of other type to this one, other is left empty
+     * time complexity: O(m * cost of pop in other)
+     */
+    template<typename Q>
+    void meld(Q &other) {
+        _self().push_bulk(take_all(other));
+    }
+
+protected:
+
+    heap_base() = default;
+
+    ~heap_base() = default;
+
+private:
+
+    D &_self() {
+        return static_cast<D &>(*this);
+    }
+};
+
+/**
+ * interface of priority queues with runtime polymorphism
+ */
 template<typename T>
 class priority_queue {
 
 public:
 
+    typedef T KEY;
+
+    virtual ~priority_queue() = default;
+
     /**
      * check if queue is empty
      */
@@ -50,7 +121,138 @@ public:
      * remove given key from queue
      */
     virtual void remove(const T &key) = 0;
+
+    /**
+     * insert all given keys, cheaper than pushing them one by one
+     */
+    virtual void push_bulk(const std::vector<T> &keys) = 0;
+
+    /**
+     * move all keys of other queue to this one, other is left empty,
+     * queues of the same type are joined without moving keys one by one
+     */
+    virtual void meld(priority_queue<T> &other) = 0;
+
+    /**
+     * insert keys from range [first, last)
+     */
+    template<typename I>
+    void build(I first, I last) {
+        push_bulk(std::vector<T>(first, last));
+    }
+};
+
+/**
+ * priority_queue backed by heap of type Q, every call costs one virtual dispatch
+ */
+template<typename Q>
+class queue_adapter : public priority_queue<typename Q::KEY> {
+
+    typedef typename Q::KEY T;
+
+public:
+
+    /**
+     * creates adapter with heap built from given arguments
+     */
+    template<typename... A>
+    explicit queue_adapter(A &&... args);
+
+    /**
+     * @return wrapped heap
+     */
+    Q &heap();
+
+    bool empty() const override;
+
+    size_t size() const override;
+
+    bool contains(const T &key) const override;
+
+    T top() const override;
+
+    void push(const T &key) override;
+
+    void pop() override;
+
+    void decrease(const T &key, const T &new_key) override;
+
+    void remove(const T &key) override;
+
+    void push_bulk(const std::vector<T> &keys) override;
+
+    void meld(priority_queue<T> &other) override;
+
+private:
+    Q q;
 };
 
+template<typename Q>
+template<typename... A>
+queue_adapter<Q>::queue_adapter(A &&... args) : q(std::forward<A>(args)...) {
+
+}
+
+template<typename Q>
+Q &queue_adapter<Q>::heap() {
+    return q;
+}
+
+template<typename Q>
+bool queue_adapter<Q>::empty() const {
+    return q.empty();
+}
+
+template<typename Q>
+size_t queue_adapter<Q>::size() const {
+    return q.size();
+}
+
+template<typename Q>
+bool queue_adapter<Q>::contains(const T &key) const {
+    return q.contains(key);
+}
+
+template<typename Q>
+typename queue_adapter<Q>::T queue_adapter<Q>::top() const {
+    return q.top();
+}
+
+template<typename Q>
+void queue_adapter<Q>::push(const T &key) {
+    q.push(key);
+}
+
+template<typename Q>
+void queue_adapter<Q>::pop() {
+    q.pop();
+}
+
+template<typename Q>
+void queue_adapter<Q>::decrease(const T &key, const T &new_key) {
+    q.decrease(key, new_key);
+}
+
+template<typename Q>
+void queue_adapter<Q>::remove(const T &key) {
+    q.remove(key);
+}
+
+template<typename Q>
+void queue_adapter<Q>::push_bulk(const std::vector<T> &keys) {
+    q.push_bulk(keys);
+}
+
+template<typename Q>
+void queue_adapter<Q>::meld(priority_queue<T> &other) {
+    if (&other == this) return;
+    auto *h = dynamic_cast<queue_adapter<Q> *>(&other);
+    if (h == nullptr) {
+        q.push_bulk(take_all(other));
+        return;
+    }
+    q.meld(h->q);
+}
+
 
 #endif //ALGORITHMS_PRIORITY_QUEUE_H
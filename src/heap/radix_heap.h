@@ -0,0 +1,319 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+#ifndef ALGORITHMS_RADIX_HEAP_H
+#define ALGORITHMS_RADIX_HEAP_H
+
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "priority_queue.h"
+#include "node_pool.h"
+
+/**
+ * monotone heap of integer keys, key pushed (or decreased to) cannot be smaller than
+ * last min seen by top or pop (until heap gets empty),
+ * which holds for Dijkstra's algorithm with non-negative weights,
+ * key goes to bucket given by highest bit in which it differs from last min,
+ * so every key moves to lower bucket at most once per bit,
+ * nodes are addressed by keys the same way as in fibonacci heap
+ */
+template<typename T>
+class radix_heap : public heap_base<radix_heap<T>, T> {
+
+    static_assert(std::is_integral<T>::value, "radix_heap needs integer keys");
+
+public:
+
+    using heap_base<radix_heap<T>, T>::meld;
+
+    /**
+     * creates empty heap
+     */
+    radix_heap();
+
+    ~radix_heap();
+
+    /**
+     * check if heap is empty
+     * time complexity: O(1)
+     */
+    bool empty() const;
+
+    /**
+     * @return number of items in heap
+     * time complexity: O(1)
+     */
+    size_t size() const;
+
+    /**
+     * check if given key belongs to heap
+     * time complexity: O(1)
+     */
+    bool contains(const T &key) const;
+
+    /**
+     * @return min key
+     * time complexity: amortized O(number of bits of T)
+     */
+    T top() const;
+
+    /**
+     * insert new key to heap
+     * time complexity: O(1)
+     */
+    void push(const T &key);
+
+    /**
+     * extract min key from heap
+     * time complexity: amortized O(number of bits of T)
+     */
+    void pop();
+
+    /**
+     * decrease value of given key
+     * time complexity: O(1)
+     */
+    void decrease(const T &key, const T &new_key);
+
+    /**
+     * remove given key from heap
+     * time complexity: O(1)
+     */
+    void remove(const T &key);
+
+    /**
+     * insert all given keys
+     * time complexity: O(k) for k keys
+     */
+    void push_bulk(const std::vector<T> &keys);
+
+    /**
+     * move all keys of other heap to this one, h is left empty,
+     * its nodes are relinked without copying,
+     * entries of smaller dictionary are moved to the larger one
+     * time complexity: O(m) for h of size m
+     */
+    void meld(radix_heap &h);
+
+private:
+    typedef typename std::make_unsigned<T>::type U;
+    static const size_t BITS = std::numeric_limits<U>::digits;
+    struct node;
+    typedef std::unordered_map<T, node *> MAP;
+    MAP node_map;
+    // bucket 0 holds only last min, bucket i keys which differ from it first on bit i - 1,
+    // buckets are refilled lazily when min is needed, so top changes them too
+    mutable std::vector<node *> buckets;
+    mutable U last;
+    size_t n;
+    node_pool<node> pool;
+    static U _order(const T &key);
+    size_t _bucket(const T &key) const;
+    void _insert(node *x) const;
+    void _unlink(node *x);
+    void _refill() const;
+};
+
+template<typename T>
+const size_t radix_heap<T>::BITS;
+
+template<typename T>
+radix_heap<T>::radix_heap() : node_map(), buckets(BITS + 1, nullptr), last(0), n(0) {
+
+}
+
+template<typename T>
+radix_heap<T>::~radix_heap() {
+    for (auto item: node_map) {
+        pool.destroy(item.second);
+    }
+}
+
+/**
+ * nodes of a bucket form doubly linked list
+ */
+template<typename T>
+struct radix_heap<T>::node {
+    T key;
+    node *l, *r;
+    size_t bucket;
+
+    explicit node(const T &key) : key(key), l(nullptr), r(nullptr), bucket(0) {}
+};
+
+template<typename T>
+bool radix_heap<T>::empty() const {
+    return n == 0;
+}
+
+template<typename T>
+size_t radix_heap<T>::size() const {
+    return n;
+}
+
+template<typename T>
+bool radix_heap<T>::contains(const T &key) const {
+    auto ptr = node_map.find(key);
+    return ptr != node_map.end();
+}
+
+template<typename T>
+T radix_heap<T>::top() const {
+    _refill();
+    return buckets[0]->key;
+}
+
+template<typename T>
+void radix_heap<T>::push(const T &key) {
+    if (n == 0) {
+        last = 0;
+    } else if (_order(key) < last) {
+        throw "key smaller than last min";
+    }
+    node *x = pool.create(key);
+    node_map[key] = x;
+    _insert(x);
+    n++;
+}
+
+template<typename T>
+void radix_heap<T>::pop() {
+    _refill();
+    remove(buckets[0]->key);
+}
+
+template<typename T>
+void radix_heap<T>::decrease(const T &key, const T &new_key) {
+    if (key < new_key) {
+        throw "cannot increase key";
+    }
+    if (_order(new_key) < last) {
+        throw "key smaller than last min";
+    }
+    node *x = node_map[key];
+    node_map.erase(key);
+    _unlink(x);
+    x->key = new_key;
+    node_map[new_key] = x;
+    _insert(x);
+}
+
+template<typename T>
+void radix_heap<T>::remove(const T &key) {
+    node *x = node_map[key];
+    node_map.erase(key);
+    _unlink(x);
+    pool.destroy(x);
+    n--;
+}
+
+template<typename T>
+void radix_heap<T>::push_bulk(const std::vector<T> &keys) {
+    node_map.reserve(n + keys.size());
+    for (auto &key: keys) {
+        push(key);
+    }
+}
+
+template<typename T>
+void radix_heap<T>::meld(radix_heap &h) {
+    if (&h == this || h.n == 0) return;
+    if (n == 0) {
+        last = 0;
+    } else if (_order(h.top()) < last) {
+        throw "key smaller than last min";
+    }
+    for (node *&b: h.buckets) {
+        while (b != nullptr) {
+            node *x = b;
+            b = x->r;
+            _insert(x);
+        }
+    }
+    n += h.n;
+    if (node_map.size() < h.node_map.size()) {
+        node_map.swap(h.node_map);
+    }
+    node_map.insert(h.node_map.begin(), h.node_map.end());
+    pool.absorb(h.pool);
+    h.node_map.clear();
+    h.n = 0;
+}
+
+/**
+ * maps key to unsigned number with the same order
+ */
+template<typename T>
+typename radix_heap<T>::U radix_heap<T>::_order(const T &key) {
+    return (U) key - (U) std::numeric_limits<T>::min();
+}
+
+template<typename T>
+size_t radix_heap<T>::_bucket(const T &key) const {
+    U diff = _order(key) ^ last;
+    if (diff == 0) {
+        return 0;
+    }
+    if (BITS <= (size_t) std::numeric_limits<unsigned>::digits) {
+        return std::numeric_limits<unsigned>::digits - __builtin_clz((unsigned) diff);
+    }
+    return std::numeric_limits<unsigned long long>::digits - __builtin_clzll((unsigned long long) diff);
+}
+
+template<typename T>
+void radix_heap<T>::_insert(node *x) const {
+    x->bucket = _bucket(x->key);
+    x->l = nullptr;
+    x->r = buckets[x->bucket];
+    if (x->r != nullptr) {
+        x->r->l = x;
+    }
+    buckets[x->bucket] = x;
+}
+
+template<typename T>
+void radix_heap<T>::_unlink(node *x) {
+    if (x->l != nullptr) {
+        x->l->r = x->r;
+    } else {
+        buckets[x->bucket] = x->r;
+    }
+    if (x->r != nullptr) {
+        x->r->l = x->l;
+    }
+}
+
+/**
+ * when last min is gone, min of first nonempty bucket becomes last min
+ * and all keys of that bucket are distributed to lower buckets
+ */
+template<typename T>
+void radix_heap<T>::_refill() const {
+    if (n == 0 || buckets[0] != nullptr) {
+        return;
+    }
+    size_t i = 1;
+    while (buckets[i] == nullptr) {
+        i++;
+    }
+    node *x = buckets[i];
+    last = _order(x->key);
+    for (node *y = x->r; y != nullptr; y = y->r) {
+        if (_order(y->key) < last) {
+            last = _order(y->key);
+        }
+    }
+    buckets[i] = nullptr;
+    while (x != nullptr) {
+        node *next = x->r;
+        _insert(x);
+        x = next;
+    }
+}
+
+
+#endif //ALGORITHMS_RADIX_HEAP_H
@@ -0,0 +1,126 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * big_numbers computed in bump_arena scope and small_vectors without an arena of their own
+ * must not keep buffers of the arena: arena is reset and refilled with other numbers before
+ * results are read, so any limb left in it is overwritten (and reported by address sanitizer
+ * when arena is destroyed)
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/big_number/big_number.h"
+#include "../src/big_number/bump_arena.h"
+#include "../src/big_number/small_vector.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *name) {
+    if (!ok) {
+        std::cerr << "FAILED: " << name << "\n";
+        failures++;
+    }
+}
+
+static big_number product_in_scope(bump_arena &arena, const std::string &digits) {
+    bump_arena::scope s(arena);
+    big_number r = big_number(digits) * big_number(digits);
+    return r;
+}
+
+// overwrites memory of arena with limbs of other numbers
+static void scribble(bump_arena &arena) {
+    arena.reset();
+    bump_arena::scope s(arena);
+    big_number junk = big_number(std::string(400, '1')) * big_number(std::string(400, '3'));
+    check(!to_string(junk, 10).empty(), "scribble");
+}
+
+int main() {
+    const std::string nines(200, '9');
+
+    {
+        big_number acc(1);
+        {
+            bump_arena arena;
+            bump_arena::scope s(arena);
+            acc = acc * big_number(nines);
+        }
+        check(to_string(acc, 10) == nines, "move assignment out of destroyed arena");
+    }
+
+    {
+        bump_arena arena;
+        big_number acc(1);
+        {
+            bump_arena::scope s(arena);
+            acc = acc * big_number(nines);
+        }
+        scribble(arena);
+        check(to_string(acc, 10) == nines, "move assignment out of reset arena");
+    }
+
+    {
+        bump_arena arena;
+        big_number acc(7);
+        {
+            bump_arena::scope s(arena);
+            acc *= big_number(nines);
+        }
+        scribble(arena);
+        check(acc == big_number(7) * big_number(nines), "compound assignment inside scope");
+    }
+
+    {
+        // operands above karatsuba threshold, smaller products are accumulated without scratch
+        const std::string big(3000, '7');
+        big_number expected = big_number(big) * big_number(big);
+        std::vector<big_number> out;
+        {
+            bump_arena arena;
+            bump_arena::scope s(arena);
+            out.push_back(big_number(big) * big_number(big));
+            out.emplace_back(big_number(big) * big_number(big));
+            check(arena.used() > 0, "multiplication in scope takes scratch from arena");
+        }
+        check(out[0] == expected && out[1] == expected, "push_back into container created outside of scope");
+    }
+
+    {
+        bump_arena arena;
+        big_number r = product_in_scope(arena, nines);
+        scribble(arena);
+        check(r == big_number(nines) * big_number(nines), "number returned from scope");
+    }
+
+    {
+        bump_arena arena;
+        small_vector<unsigned, 4> outside;
+        {
+            bump_arena::scope s(arena);
+            for (unsigned i = 0; i < 1000; i++) {
+                outside.push_back(i);
+            }
+            small_vector<unsigned, 4> inside(&arena);
+            inside.insert(inside.end(), outside.begin(), outside.end());
+            check(arena.used() > 0, "vector given an arena takes its buffer");
+            small_vector<unsigned, 4> moved(std::move(inside));
+            outside.swap(moved);
+        }
+        scribble(arena);
+        bool same = outside.size() == 1000;
+        for (unsigned i = 0; same && i < 1000; i++) {
+            same = outside[i] == i;
+        }
+        check(same, "growth, move and swap of vectors without arena");
+    }
+
+    if (failures == 0) {
+        std::cout << "all passed\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
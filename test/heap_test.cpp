@@ -0,0 +1,189 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * random sequences of push, pop, decrease, remove, push_bulk and meld are run on every heap
+ * and on std::set with the same comparator, top, size and contains have to agree after each step
+ * and heap has to hand out the keys of the set in order at the end
+ */
+
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+#include "../src/heap/binary_heap.h"
+#include "../src/heap/d_ary_heap.h"
+#include "../src/heap/fibonacci_heap.h"
+#include "../src/heap/pairing_heap.h"
+#include "../src/heap/priority_queue.h"
+#include "../src/heap/radix_heap.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *name) {
+    if (!ok) {
+        std::cerr << "FAILED: " << name << "\n";
+        failures++;
+    }
+}
+
+/**
+ * H is tested heap, M1 and M2 are types of heaps melded into it,
+ * monotone heaps get only keys not smaller than the last min seen by top or pop
+ */
+template<typename H, typename M1, typename M2, typename C = std::less<int>>
+class heap_test {
+
+public:
+
+    heap_test(const char *name, bool monotone, unsigned seed) : name(name), monotone(monotone), gen(seed), floor(0) {
+
+    }
+
+    void run(int steps) {
+        bool ok = true;
+        for (int i = 0; ok && i < steps; i++) {
+            unsigned op = gen() % 20;
+            // push, push_bulk and meld add more keys than pop and remove take,
+            // so they are replaced by pop when heap is big enough
+            if (keys.size() >= 1000 && (op < 6 || (op >= 15 && op < 19))) {
+                op = 6;
+            }
+            if (op < 6) {
+                _push();
+            } else if (op < 10) {
+                _pop();
+            } else if (op < 13) {
+                _decrease();
+            } else if (op < 15) {
+                _remove();
+            } else if (op < 17) {
+                _push_bulk();
+            } else if (op == 17) {
+                ok = _meld<M1>();
+            } else if (op == 18) {
+                ok = _meld<M2>();
+            } else {
+                int key = (int) (gen() % 1000000);
+                ok = h.contains(key) == (keys.count(key) > 0);
+            }
+            ok = ok && h.size() == keys.size() && h.empty() == keys.empty() && (keys.empty() || _top() == *keys.begin());
+        }
+        check(ok, name);
+
+        std::vector<int> expected(keys.begin(), keys.end());
+        check(take_all(h) == expected && h.empty(), name);
+    }
+
+private:
+    const char *name;
+    bool monotone;
+    std::mt19937 gen;
+    // last min seen by top or pop
+    int floor;
+    H h;
+    std::set<int, C> keys;
+    C before;
+
+    int _top() {
+        floor = h.top();
+        return floor;
+    }
+
+    int _fresh_key() {
+        int key;
+        do {
+            key = (int) (gen() % 1000000) + (monotone ? floor : 0);
+        } while (keys.count(key) > 0);
+        return key;
+    }
+
+    int _random_key() {
+        auto it = keys.begin();
+        std::advance(it, gen() % keys.size());
+        return *it;
+    }
+
+    void _push() {
+        int key = _fresh_key();
+        keys.insert(key);
+        h.push(key);
+    }
+
+    void _pop() {
+        if (keys.empty()) return;
+        _top();
+        keys.erase(keys.begin());
+        h.pop();
+    }
+
+    void _decrease() {
+        if (keys.empty()) return;
+        int key = _random_key();
+        for (int attempt = 0; attempt < 10; attempt++) {
+            int new_key = key + (int) (gen() % 2001) - 1000;
+            if (before(new_key, key) && keys.count(new_key) == 0 && (!monotone || new_key >= floor)) {
+                keys.erase(key);
+                keys.insert(new_key);
+                h.decrease(key, new_key);
+                return;
+            }
+        }
+    }
+
+    void _remove() {
+        if (keys.empty()) return;
+        int key = _random_key();
+        keys.erase(key);
+        h.remove(key);
+    }
+
+    void _push_bulk() {
+        std::vector<int> bulk;
+        for (unsigned k = gen() % 50; k > 0; k--) {
+            bulk.push_back(_fresh_key());
+            keys.insert(bulk.back());
+        }
+        h.push_bulk(bulk);
+    }
+
+    template<typename M>
+    bool _meld() {
+        M other;
+        for (unsigned k = gen() % 100; k > 0; k--) {
+            int key = _fresh_key();
+            keys.insert(key);
+            other.push(key);
+        }
+        h.meld(other);
+        return other.empty();
+    }
+};
+
+template<typename H, typename M1, typename M2, typename C = std::less<int>>
+static void test_heap(const char *name, bool monotone = false) {
+    for (unsigned seed = 1; seed <= 5; seed++) {
+        heap_test<H, M1, M2, C>(name, monotone, seed).run(20000);
+    }
+}
+
+int main() {
+    typedef std::greater<int> G;
+    test_heap<fibonacci_heap<int>, fibonacci_heap<int>, pairing_heap<int>>("fibonacci_heap");
+    test_heap<pairing_heap<int>, pairing_heap<int>, binary_heap<int>>("pairing_heap");
+    test_heap<radix_heap<int>, radix_heap<int>, fibonacci_heap<int>>("radix_heap", true);
+    test_heap<d_ary_heap<int, 4>, d_ary_heap<int, 4>, binary_heap<int>>("d_ary_heap<4>");
+    test_heap<d_ary_heap<int, 8>, d_ary_heap<int, 8>, pairing_heap<int>>("d_ary_heap<8>");
+    test_heap<binary_heap<int, G>, binary_heap<int, G>, pairing_heap<int, G>, G>("binary_heap<greater>");
+    test_heap<queue_adapter<fibonacci_heap<int>>, queue_adapter<fibonacci_heap<int>>,
+            queue_adapter<pairing_heap<int>>>("queue_adapter");
+
+    if (failures == 0) {
+        std::cout << "all passed\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
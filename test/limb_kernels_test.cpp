@@ -0,0 +1,116 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * every instruction set supported by CPU must give the same limbs, carries and borrows
+ * as the scalar kernels, on random limbs and on long chains of 999999999 and 0 limbs
+ * which carry or borrow through the whole vector
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../src/big_number/limb_kernels.h"
+
+typedef std::vector<uint32_t> LIMBS;
+
+static int failures = 0;
+
+static void check(bool ok, const char *name, limb_kernels::ISA isa) {
+    if (!ok) {
+        std::cerr << "FAILED: " << name << " (isa " << isa << ")\n";
+        failures++;
+    }
+}
+
+// random limb, extreme values are drawn often to make carries and borrows common
+static uint32_t random_limb(std::mt19937 &gen) {
+    switch (gen() % 4) {
+        case 0:
+            return limb_kernels::BASE - 1;
+        case 1:
+            return 0;
+        case 2:
+            return 1;
+        default:
+            return gen() % limb_kernels::BASE;
+    }
+}
+
+static LIMBS random_limbs(std::mt19937 &gen, size_t n) {
+    LIMBS a(n);
+    for (auto &x: a) {
+        x = random_limb(gen);
+    }
+    return a;
+}
+
+// runs add and sub with isa and scalar kernels and compares results, also in place
+static void compare_add_sub(limb_kernels::ISA isa, const LIMBS &a, const LIMBS &b) {
+    size_t n = a.size();
+    LIMBS r(n), s(n), expected_r(n), expected_s(n);
+    limb_kernels::select(limb_kernels::SCALAR);
+    uint32_t carry = limb_kernels::add(expected_r.data(), a.data(), b.data(), n);
+    uint32_t borrow = limb_kernels::sub(expected_s.data(), a.data(), b.data(), n);
+    limb_kernels::select(isa);
+    check(limb_kernels::add(r.data(), a.data(), b.data(), n) == carry && r == expected_r, "add", isa);
+    check(limb_kernels::sub(s.data(), a.data(), b.data(), n) == borrow && s == expected_s, "sub", isa);
+    r = a;
+    s = a;
+    check(limb_kernels::add(r.data(), r.data(), b.data(), n) == carry && r == expected_r, "add in place", isa);
+    check(limb_kernels::sub(s.data(), s.data(), b.data(), n) == borrow && s == expected_s, "sub in place", isa);
+}
+
+static void test_isa(limb_kernels::ISA isa) {
+    std::mt19937 gen(isa);
+    for (int it = 0; it < 5000; it++) {
+        size_t n = gen() % 100;
+        compare_add_sub(isa, random_limbs(gen, n), random_limbs(gen, n));
+    }
+
+    for (size_t n: {1, 7, 8, 15, 16, 17, 1000, 1001}) {
+        LIMBS nines(n, limb_kernels::BASE - 1), zeros(n, 0), one(n, 0), all_ones(n, 1);
+        one[0] = 1;
+        compare_add_sub(isa, nines, one);
+        compare_add_sub(isa, nines, all_ones);
+        compare_add_sub(isa, nines, nines);
+        compare_add_sub(isa, zeros, one);
+        compare_add_sub(isa, one, nines);
+    }
+
+    for (int it = 0; it < 2000; it++) {
+        size_t n = gen() % 100;
+        LIMBS a = random_limbs(gen, n);
+        std::vector<uint64_t> acc(n), expected(n);
+        for (size_t i = 0; i < n; i++) {
+            acc[i] = expected[i] = random_limb(gen);
+        }
+        // up to 18 updates, the most one entry can take
+        for (int k = gen() % 19; k > 0; k--) {
+            uint32_t q = k % 2 ? limb_kernels::BASE - 1 : random_limb(gen);
+            limb_kernels::select(limb_kernels::SCALAR);
+            limb_kernels::addmul(expected.data(), a.data(), n, q);
+            limb_kernels::select(isa);
+            limb_kernels::addmul(acc.data(), a.data(), n, q);
+        }
+        check(acc == expected, "addmul", isa);
+    }
+}
+
+int main() {
+    limb_kernels::ISA best = limb_kernels::best();
+    for (int isa = limb_kernels::SCALAR; isa <= best; isa++) {
+        limb_kernels::select((limb_kernels::ISA) isa);
+        check(limb_kernels::current() == isa, "select", (limb_kernels::ISA) isa);
+        test_isa((limb_kernels::ISA) isa);
+    }
+    limb_kernels::select(best);
+
+    if (failures == 0) {
+        std::cout << "all passed\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
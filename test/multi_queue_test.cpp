@@ -0,0 +1,84 @@
+//
+// Created by Antoni Solarski
+// github.com/Antsol1000
+//
+
+/**
+ * producers push distinct keys while consumers pop them concurrently,
+ * every key has to be popped exactly once and queue has to be empty afterwards
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../src/heap/multi_queue.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *name) {
+    if (!ok) {
+        std::cerr << "FAILED: " << name << "\n";
+        failures++;
+    }
+}
+
+static void test_producers_consumers(unsigned producers, unsigned consumers, int keys) {
+    multi_queue<int> q(producers + consumers);
+    std::atomic<unsigned> finished(0);
+    std::vector<std::vector<int>> popped(consumers);
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+        threads.emplace_back([&q, &finished, p, keys] {
+            for (int i = 0; i < keys; i++) {
+                q.push((int) p * keys + i);
+            }
+            finished++;
+        });
+    }
+    for (unsigned c = 0; c < consumers; c++) {
+        threads.emplace_back([&q, &finished, &popped, c, producers] {
+            // pop may miss keys in heaps locked by other threads, so queue is drained until empty
+            int key;
+            while (true) {
+                if (q.pop(key)) {
+                    popped[c].push_back(key);
+                } else if (finished == producers && q.empty()) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    std::vector<int> all;
+    for (auto &keys_of_consumer: popped) {
+        all.insert(all.end(), keys_of_consumer.begin(), keys_of_consumer.end());
+    }
+    std::sort(all.begin(), all.end());
+    bool once = all.size() == (size_t) producers * keys;
+    for (size_t i = 0; once && i < all.size(); i++) {
+        once = all[i] == (int) i;
+    }
+    check(once, "every key popped exactly once");
+    check(q.empty() && q.size() == 0, "queue empty after all pops");
+    int key;
+    check(!q.pop(key) && !q.top(key), "nothing left to pop");
+}
+
+int main() {
+    test_producers_consumers(1, 1, 50000);
+    test_producers_consumers(4, 4, 20000);
+    test_producers_consumers(8, 2, 10000);
+    test_producers_consumers(2, 8, 40000);
+
+    if (failures == 0) {
+        std::cout << "all passed\n";
+    }
+    return failures == 0 ? 0 : 1;
+}